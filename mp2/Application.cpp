@@ -6,6 +6,8 @@
 
 #include "Application.h"
 
+#include <sys/resource.h>
+
 void handler(int sig) {
     void *array[10];
     size_t size;
@@ -46,12 +48,17 @@ int main(int argc, char *argv[]) {
  */
 Application::Application(char *infile) {
     int i;
+    TRACE_OPEN(TRACE_FILE);
     par = new Params();
-    srand(time(NULL));
     par->setparams(infile);
+    rng.seed(par->SEED, APPLICATION_STREAM, 0);
+    convergenceTime = -1;
+    cout << "Random seed: " << par->SEED << endl;
     log = new Log(par);
-    en = new EmulNet(par);
-    en1 = new EmulNet(par);
+    profiler = new Profiler(par->EN_GPSZ);
+    en = new EmulNet(par, profiler, &MP1Node::trafficClass);
+    en1 = new EmulNet(par, profiler, &MP2Node::trafficClass);
+    latency = new Latency();
     mp1 = (MP1Node **)malloc(par->EN_GPSZ * sizeof(MP1Node *));
     mp2 = (MP2Node **)malloc(par->EN_GPSZ * sizeof(MP2Node *));
 
@@ -67,9 +74,10 @@ Application::Application(char *infile) {
         addressOfMemberNode =
             (Address *)en->ENinit(addressOfMemberNode, par->PORTNUM);
         mp1[i] = new MP1Node(memberNode, par, en, log, addressOfMemberNode);
-        mp2[i] = new MP2Node(memberNode, par, en1, log, addressOfMemberNode);
-        log->LOG(&(mp1[i]->getMemberNode()->addr), "APP");
-        log->LOG(&(mp2[i]->getMemberNode()->addr), "APP MP2");
+        mp2[i] = new MP2Node(memberNode, par, en1, log, latency,
+                             addressOfMemberNode);
+        LOG_DEBUG(log, LOG_APP, &(mp1[i]->getMemberNode()->addr), "APP");
+        LOG_DEBUG(log, LOG_APP, &(mp2[i]->getMemberNode()->addr), "APP MP2");
         delete addressOfMemberNode;
     }
 }
@@ -81,6 +89,8 @@ Application::~Application() {
     delete log;
     delete en;
     delete en1;
+    delete latency;
+    delete profiler;
     for (int i = 0; i < par->EN_GPSZ; i++) {
         delete mp1[i];
         delete mp2[i];
@@ -100,14 +110,22 @@ int Application::run() {
     int timeWhenAllNodesHaveJoined = 0;
     // boolean indicating if all nodes have joined
     bool allNodesJoined = false;
-    srand(time(NULL));
+
+    runStart = chrono::steady_clock::now();
 
     // As time runs along
-    for (par->globaltime = 0; par->globaltime < TOTAL_RUNNING_TIME;
+    for (par->globaltime = 0; par->globaltime < par->TOTAL_RUNNING_TIME;
          ++par->globaltime) {
+        TRACE_COUNTER("time", par->globaltime);
         // Run the membership protocol
         mp1Run();
 
+        if (convergenceTime < 0 && membershipConverged()) {
+            convergenceTime = par->getcurrtime();
+            cout << "Membership converged at time: " << convergenceTime
+                 << endl;
+        }
+
         // Wait for all nodes to join
         if (par->allNodesJoined == nodeCount && !allNodesJoined) {
             timeWhenAllNodesHaveJoined = par->getcurrtime();
@@ -117,13 +135,39 @@ int Application::run() {
             // Call the KV store functionalities
             mp2Run();
         }
+        // Drop messages from time 50 to 300
+        if (par->DROP_MSG && par->getcurrtime() == 50) {
+            par->dropmsg = 1;
+        }
+        if (par->DROP_MSG && par->getcurrtime() == 300) {
+            par->dropmsg = 0;
+        }
         // Fail some nodes
-        // fail();
+        if (par->FAIL_TIME >= 0) {
+            fail();
+        }
     }
 
+    cout << "Membership messages: " << en->getTotalMsgs()
+         << " bytes: " << en->getTotalBytes() << endl;
+    summary();
+
     // Clean up
-    en->ENcleanup();
-    en1->ENcleanup();
+    FILE *msgcount = fopen(MSGCOUNT_LOG, "w+");
+    en->ENcleanup(msgcount);
+    en1->ENcleanup(msgcount);
+    if (msgcount != NULL) fclose(msgcount);
+
+    FILE *traffic = fopen(TRAFFIC_LOG, "w+");
+    if (traffic != NULL) {
+        fprintf(traffic, TRAFFIC_HEADER);
+        en->ENtraffic(traffic);
+        en1->ENtraffic(traffic);
+        fclose(traffic);
+    }
+    latency->dump(LATENCY_LOG);
+    profiler->dump(PROFILE_LOG);
+    TRACE_CLOSE();
 
     for (i = 0; i <= par->EN_GPSZ - 1; i++) {
         mp1[i]->finishUpThisNode();
@@ -150,6 +194,8 @@ void Application::mp1Run() {
         if (par->getcurrtime() > (int)(par->STEP_RATE * i) &&
             !(mp1[i]->getMemberNode()->bFailed)) {
             // Receive messages from the network and queue them
+            ScopedTimer timer(profiler, PHASE_MP1_RECV, i);
+            TRACE_SCOPE("mp1.recvLoop", i + 1);
             mp1[i]->recvLoop();
         }
     }
@@ -173,13 +219,15 @@ void Application::mp1Run() {
         else if (par->getcurrtime() > (int)(par->STEP_RATE * i) &&
                  !(mp1[i]->getMemberNode()->bFailed)) {
             // handle messages and send heartbeats
-            mp1[i]->nodeLoop();
-#ifdef DEBUGLOG
+            {
+                ScopedTimer timer(profiler, PHASE_MP1_NODELOOP, i);
+                TRACE_SCOPE("mp1.nodeLoop", i + 1);
+                mp1[i]->nodeLoop();
+            }
             if ((i == 0) && (par->globaltime % 500 == 0)) {
-                log->LOG(&mp1[i]->getMemberNode()->addr, "@@time=%d",
-                         par->getcurrtime());
+                LOG_DEBUG(log, LOG_APP, &mp1[i]->getMemberNode()->addr,
+                          "@@time=%d", par->getcurrtime());
             }
-#endif
         }
     }
 }
@@ -205,9 +253,13 @@ void Application::mp2Run() {
             if (mp2[i]->getMemberNode()->inited &&
                 mp2[i]->getMemberNode()->inGroup) {
                 // Step 1
+                ScopedTimer timer(profiler, PHASE_MP2_UPDATERING, i);
+                TRACE_SCOPE("mp2.updateRing", i + 1);
                 mp2[i]->updateRing();
             }
             // Step 2
+            ScopedTimer timer(profiler, PHASE_MP2_RECV, i);
+            TRACE_SCOPE("mp2.recvLoop", i + 1);
             mp2[i]->recvLoop();
         }
     }
@@ -218,6 +270,8 @@ void Application::mp2Run() {
     for (i = par->EN_GPSZ - 1; i >= 0; i--) {
         if (par->getcurrtime() > (int)(par->STEP_RATE * i) &&
             !mp2[i]->getMemberNode()->bFailed) {
+            ScopedTimer timer(profiler, PHASE_MP2_CHECK, i);
+            TRACE_SCOPE("mp2.checkMessages", i + 1);
             mp2[i]->checkMessages();
         }
     }
@@ -225,14 +279,14 @@ void Application::mp2Run() {
     /**
      * Insert a set of test key value pairs into the system
      */
-    if (par->getcurrtime() == INSERT_TIME) {
+    if (par->getcurrtime() == par->INSERT_TIME) {
         insertTestKVPairs();
     }
 
     /**
      * Test CRUD operations
      */
-    if (par->getcurrtime() >= TEST_TIME) {
+    if (par->getcurrtime() >= par->TEST_TIME) {
         /**************
          * CREATE TEST
          **************/
@@ -241,7 +295,8 @@ void Application::mp2Run() {
          * message are in the log
          *
          */
-        if (par->getcurrtime() == TEST_TIME && CREATE_TEST == par->CRUDTEST) {
+        if (par->getcurrtime() == par->TEST_TIME &&
+            CREATE_TEST == par->CRUDTEST) {
             cout << endl
                  << "Doing create test at time: " << par->getcurrtime() << endl;
         }  // End of create test
@@ -256,7 +311,7 @@ void Application::mp2Run() {
          * DELETE FAIL message in the lgo
          *
          */
-        else if (par->getcurrtime() == TEST_TIME &&
+        else if (par->getcurrtime() == par->TEST_TIME &&
                  DELETE_TEST == par->CRUDTEST) {
             deleteTest();
         }  // End of delete test
@@ -295,7 +350,7 @@ void Application::mp2Run() {
          * log
          *
          */
-        else if (par->getcurrtime() >= TEST_TIME &&
+        else if (par->getcurrtime() >= par->TEST_TIME &&
                  READ_TEST == par->CRUDTEST) {
             readTest();
         }  // end of read test
@@ -334,12 +389,19 @@ void Application::mp2Run() {
          * the log
          *
          */
-        else if (par->getcurrtime() >= TEST_TIME &&
+        else if (par->getcurrtime() >= par->TEST_TIME &&
                  UPDATE_TEST == par->CRUDTEST) {
             updateTest();
         }  // End of update test
 
     }  // end of if ( par->getcurrtime == TEST_TIME)
+
+    /**
+     * Keep the ring busy with reads and updates of the test keys
+     */
+    if (par->OPS_PER_TICK > 0 && par->getcurrtime() >= par->TEST_TIME) {
+        workload();
+    }
 }
 
 /**
@@ -353,31 +415,19 @@ void Application::fail() {
     int i, removed;
 
     // fail half the members at time t=400
-    if (par->DROP_MSG && par->getcurrtime() == 50) {
-        par->dropmsg = 1;
-    }
-
-    if (par->SINGLE_FAILURE && par->getcurrtime() == 100) {
-        removed = (rand() % par->EN_GPSZ);
-#ifdef DEBUGLOG
-        log->LOG(&mp1[removed]->getMemberNode()->addr, "Node failed at time=%d",
-                 par->getcurrtime());
-#endif
+    if (par->SINGLE_FAILURE && par->getcurrtime() == par->FAIL_TIME) {
+        removed = rng.nextInt(par->EN_GPSZ);
+        LOG_INFO(log, LOG_APP, &mp1[removed]->getMemberNode()->addr,
+                 "Node failed at time=%d", par->getcurrtime());
         mp1[removed]->getMemberNode()->bFailed = true;
-    } else if (par->getcurrtime() == 100) {
-        removed = rand() % par->EN_GPSZ / 2;
+    } else if (par->getcurrtime() == par->FAIL_TIME) {
+        removed = rng.nextInt(par->EN_GPSZ) / 2;
         for (i = removed; i < removed + par->EN_GPSZ / 2; i++) {
-#ifdef DEBUGLOG
-            log->LOG(&mp1[i]->getMemberNode()->addr, "Node failed at time = %d",
-                     par->getcurrtime());
-#endif
+            LOG_INFO(log, LOG_APP, &mp1[i]->getMemberNode()->addr,
+                     "Node failed at time = %d", par->getcurrtime());
             mp1[i]->getMemberNode()->bFailed = true;
         }
     }
-
-    if (par->DROP_MSG && par->getcurrtime() == 300) {
-        par->dropmsg = 0;
-    }
 }
 
 /**
@@ -386,12 +436,11 @@ void Application::fail() {
  * DESCRIPTION: This function returns the address of the coordinator
  */
 Address Application::getjoinaddr(void) {
-    // trace.funcEntry("Application::getjoinaddr");
+    TRACE_SCOPE("Application::getjoinaddr", 0);
     Address joinaddr;
     joinaddr.init();
     *(int *)(&(joinaddr.addr)) = 1;
     *(short *)(&(joinaddr.addr[4])) = 0;
-    // trace.funcExit("Application::getjoinaddr", SUCCESS);
     return joinaddr;
 }
 
@@ -403,31 +452,71 @@ Address Application::getjoinaddr(void) {
 int Application::findARandomNodeThatIsAlive() {
     int number;
     do {
-        number = (rand() % par->EN_GPSZ);
+        number = rng.nextInt(par->EN_GPSZ);
     } while (mp2[number]->getMemberNode()->bFailed);
     return number;
 }
 
+/**
+ * FUNCTION NAME: membershipConverged
+ *
+ * DESCRIPTION: Returns true once every node has been introduced and every
+ * live node has all live nodes in its membership list
+ */
+bool Application::membershipConverged() {
+    if (par->getcurrtime() <= (int)(par->STEP_RATE * (par->EN_GPSZ - 1))) {
+        return false;
+    }
+
+    size_t alive = 0;
+    for (int i = 0; i < par->EN_GPSZ; i++) {
+        if (!mp1[i]->getMemberNode()->bFailed) alive++;
+    }
+    for (int i = 0; i < par->EN_GPSZ; i++) {
+        Member *m = mp1[i]->getMemberNode();
+        if (!m->bFailed && m->memberList.size() != alive) return false;
+    }
+    return true;
+}
+
 /**
  * FUNCTION NAME: initTestKVPairs
  *
  * DESCRIPTION: Init NUMBER_OF_INSERTS test KV pairs in the map
  */
 void Application::initTestKVPairs() {
-    srand(time(NULL));
-    int i;
     string key;
-    key.clear();
     testKVPairs.clear();
+    while (testKVPairs.size() != (size_t)par->NUMBER_OF_INSERTS) {
+        key = randomString(par->KEY_LENGTH);
+        testKVPairs[key] = randomValue();
+    }
+}
+
+/**
+ * FUNCTION NAME: randomValue
+ *
+ * DESCRIPTION: Returns a random test value, VALUE_LENGTH characters long or
+ * "value<n>" when VALUE_LENGTH is 0
+ */
+string Application::randomValue() {
+    if (par->VALUE_LENGTH > 0) return randomString(par->VALUE_LENGTH);
+    return "value" + to_string(rng.nextInt(par->NUMBER_OF_INSERTS));
+}
+
+/**
+ * FUNCTION NAME: randomString
+ *
+ * DESCRIPTION: Returns a random alphanumeric string of the given length
+ */
+string Application::randomString(int length) {
     int alphanumLen = sizeof(alphanum) - 1;
-    while (testKVPairs.size() != NUMBER_OF_INSERTS) {
-        for (i = 0; i < KEY_LENGTH; i++) {
-            key.push_back(alphanum[rand() % alphanumLen]);
-        }
-        string value = "value" + to_string(rand() % NUMBER_OF_INSERTS);
-        testKVPairs[key] = value;
-        key.clear();
+    string str;
+    str.reserve(length);
+    for (int i = 0; i < length; i++) {
+        str.push_back(alphanum[rng.nextInt(alphanumLen)]);
     }
+    return str;
 }
 
 /**
@@ -442,6 +531,7 @@ void Application::insertTestKVPairs() {
      * Init a few test key value pairs
      */
     initTestKVPairs();
+    insertStart = chrono::steady_clock::now();
 
     for (map<string, string>::iterator it = testKVPairs.begin();
          it != testKVPairs.end(); ++it) {
@@ -458,6 +548,61 @@ void Application::insertTestKVPairs() {
     cout << endl
          << "Sent " << testKVPairs.size() << " create messages to the ring"
          << endl;
+
+    if (par->OPS_PER_TICK > 0) {
+        workloadKeys.clear();
+        for (auto &kv : testKVPairs) workloadKeys.push_back(kv.first);
+    }
+}
+
+/**
+ * FUNCTION NAME: workload
+ *
+ * DESCRIPTION: Issues OPS_PER_TICK client operations on random test keys from
+ * random live nodes, READ_PERCENT percent of them reads and the rest updates.
+ * 				The operations are not logged as OPERATION lines, so a
+ * graded CRUD test sees only its own.
+ */
+void Application::workload() {
+    int number;
+
+    if (workloadKeys.empty()) return;
+
+    for (int i = 0; i < par->OPS_PER_TICK; i++) {
+        number = findARandomNodeThatIsAlive();
+        const string &key = workloadKeys[rng.nextInt(workloadKeys.size())];
+        if ((int)rng.nextInt(100) < par->READ_PERCENT) {
+            mp2[number]->clientRead(key);
+        } else {
+            mp2[number]->clientUpdate(key, randomValue());
+        }
+    }
+}
+
+/**
+ * FUNCTION NAME: summary
+ *
+ * DESCRIPTION: Prints the cost of the run: wall-clock time per time unit,
+ * peak RSS, messages of both layers per time unit, and the client operations
+ * that reached or missed their quorum per wall-clock second since the test KV
+ * pairs were inserted
+ */
+void Application::summary() {
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    double wall = chrono::duration<double>(end - runStart).count();
+    double load = chrono::duration<double>(end - insertStart).count();
+    int ticks = par->TOTAL_RUNNING_TIME;
+    long messages = en->getTotalMsgs() + en1->getTotalMsgs();
+    long ops = latency->decided();
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+    printf(
+        "Run summary: ticks %d wall_s %.3f us_per_tick %.1f peak_rss_kb %ld "
+        "msgs_per_tick %.1f ops %ld ops_per_sec %.1f\n",
+        ticks, wall, ticks > 0 ? wall * 1e6 / ticks : 0, usage.ru_maxrss,
+        ticks > 0 ? (double)messages / ticks : 0, ops,
+        ops > 0 && load > 0 ? ops / load : 0);
 }
 
 /**
@@ -521,7 +666,7 @@ void Application::readTest() {
      * Test 1: Test if value of a single read operation is read correctly in
      * quorum number of nodes
      */
-    if (par->getcurrtime() == TEST_TIME) {
+    if (par->getcurrtime() == par->TEST_TIME) {
         // Step 1.a. Find a node that is alive
         number = findARandomNodeThatIsAlive();
 
@@ -539,7 +684,7 @@ void Application::readTest() {
      * Test 2: FAIL ONE REPLICA. Test if value is read correctly in quorum
      * number of nodes after ONE OF THE REPLICAS IS FAILED
      */
-    if (par->getcurrtime() == (TEST_TIME + FIRST_FAIL_TIME)) {
+    if (par->getcurrtime() == (par->TEST_TIME + FIRST_FAIL_TIME)) {
         // Step 2.a Find a node that is alive and assign it as number
         number = findARandomNodeThatIsAlive();
 
@@ -611,13 +756,14 @@ void Application::readTest() {
      * quorum number of nodes after TWO OF THE REPLICAS ARE FAILED
      */
     // Wait for STABILIZE_TIME and fail two replicas
-    if (par->getcurrtime() >= (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME)) {
+    if (par->getcurrtime() >=
+        (par->TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME)) {
         vector<int> nodesToFail;
         nodesToFail.clear();
         int count = 0;
 
         if (par->getcurrtime() ==
-            (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME)) {
+            (par->TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME)) {
             // Step 3.a. Find a node that is alive
             number = findARandomNodeThatIsAlive();
 
@@ -695,7 +841,8 @@ void Application::readTest() {
          */
         // Step 3.d Wait for stabilization protocol to kick in
         if (par->getcurrtime() ==
-            (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME + STABILIZE_TIME)) {
+            (par->TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME +
+             STABILIZE_TIME)) {
             number = findARandomNodeThatIsAlive();
             // Step 3.e Issue a read
             cout << endl << "Reading a valid key.... ... .. . ." << endl;
@@ -713,8 +860,9 @@ void Application::readTest() {
      * Test 4: FAIL A NON-REPLICA. Test if value is read correctly in quorum
      * number of nodes after a NON-REPLICA IS FAILED
      */
-    if (par->getcurrtime() == (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME +
-                               STABILIZE_TIME + LAST_FAIL_TIME)) {
+    if (par->getcurrtime() == (par->TEST_TIME + FIRST_FAIL_TIME +
+                               STABILIZE_TIME + STABILIZE_TIME +
+                               LAST_FAIL_TIME)) {
         // Step 4.a. Find a node that is alive
         number = findARandomNodeThatIsAlive();
 
@@ -764,8 +912,9 @@ void Application::readTest() {
     /**
      * Test 5: Read a non-existent key.
      */
-    if (par->getcurrtime() == (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME +
-                               STABILIZE_TIME + LAST_FAIL_TIME)) {
+    if (par->getcurrtime() == (par->TEST_TIME + FIRST_FAIL_TIME +
+                               STABILIZE_TIME + STABILIZE_TIME +
+                               LAST_FAIL_TIME)) {
         string invalidKey = "invalidKey";
 
         // Step 5.a Find a node that is alive
@@ -803,7 +952,7 @@ void Application::updateTest() {
     /**
      * Test 1: Test if value is updated correctly in quorum number of nodes
      */
-    if (par->getcurrtime() == TEST_TIME) {
+    if (par->getcurrtime() == par->TEST_TIME) {
         // Step 1.a. Find a node that is alive
         number = findARandomNodeThatIsAlive();
 
@@ -821,7 +970,7 @@ void Application::updateTest() {
      * Test 2: FAIL ONE REPLICA. Test if value is updated correctly in quorum
      * number of nodes after ONE OF THE REPLICAS IS FAILED
      */
-    if (par->getcurrtime() == (TEST_TIME + FIRST_FAIL_TIME)) {
+    if (par->getcurrtime() == (par->TEST_TIME + FIRST_FAIL_TIME)) {
         // Step 2.a Find a node that is alive and assign it as number
         number = findARandomNodeThatIsAlive();
 
@@ -892,13 +1041,14 @@ void Application::updateTest() {
      * Test 3 part 1: Fail two replicas. Test if value is updated correctly in
      * quorum number of nodes after TWO OF THE REPLICAS ARE FAILED
      */
-    if (par->getcurrtime() >= (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME)) {
+    if (par->getcurrtime() >=
+        (par->TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME)) {
         vector<int> nodesToFail;
         nodesToFail.clear();
         int count = 0;
 
         if (par->getcurrtime() ==
-            (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME)) {
+            (par->TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME)) {
             // Step 3.a. Find a node that is alive
             number = findARandomNodeThatIsAlive();
 
@@ -973,7 +1123,8 @@ void Application::updateTest() {
          */
         // Step 3.d Wait for stabilization protocol to kick in
         if (par->getcurrtime() ==
-            (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME + STABILIZE_TIME)) {
+            (par->TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME +
+             STABILIZE_TIME)) {
             number = findARandomNodeThatIsAlive();
             // Step 3.e Issue a update
             cout << endl << "Updating a valid key.... ... .. . ." << endl;
@@ -991,8 +1142,9 @@ void Application::updateTest() {
      * Test 4: FAIL A NON-REPLICA. Test if value is read correctly in quorum
      * number of nodes after a NON-REPLICA IS FAILED
      */
-    if (par->getcurrtime() == (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME +
-                               STABILIZE_TIME + LAST_FAIL_TIME)) {
+    if (par->getcurrtime() == (par->TEST_TIME + FIRST_FAIL_TIME +
+                               STABILIZE_TIME + STABILIZE_TIME +
+                               LAST_FAIL_TIME)) {
         // Step 4.a. Find a node that is alive
         number = findARandomNodeThatIsAlive();
 
@@ -1043,8 +1195,9 @@ void Application::updateTest() {
     /**
      * Test 5: Udpate a non-existent key.
      */
-    if (par->getcurrtime() == (TEST_TIME + FIRST_FAIL_TIME + STABILIZE_TIME +
-                               STABILIZE_TIME + LAST_FAIL_TIME)) {
+    if (par->getcurrtime() == (par->TEST_TIME + FIRST_FAIL_TIME +
+                               STABILIZE_TIME + STABILIZE_TIME +
+                               LAST_FAIL_TIME)) {
         string invalidKey = "invalidKey";
         string invalidValue = "invalidValue";
 
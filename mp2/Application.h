@@ -14,7 +14,10 @@
 #include "Member.h"
 #include "Node.h"
 #include "Params.h"
+#include "Profiler.h"
 #include "Queue.h"
+#include "Random.h"
+#include "Trace.h"
 #include "common.h"
 #include "stdincludes.h"
 
@@ -31,15 +34,10 @@ static const char alphanum[] =
  * Macros
  */
 #define ARGS_COUNT 2
-#define TOTAL_RUNNING_TIME 700
-#define INSERT_TIME (TOTAL_RUNNING_TIME - 600)
-#define TEST_TIME (INSERT_TIME + 50)
 #define STABILIZE_TIME 50
 #define FIRST_FAIL_TIME 25
 #define LAST_FAIL_TIME 10
 #define RF 3
-#define NUMBER_OF_INSERTS 100
-#define KEY_LENGTH 5
 
 /**
  * CLASS NAME: Application
@@ -54,22 +52,37 @@ class Application {
     EmulNet *en;
     EmulNet *en1;
     Log *log;
+    Latency *latency;
+    Profiler *profiler;
     MP1Node **mp1;
     MP2Node **mp2;
     Params *par;
     map<string, string> testKVPairs;
+    // keys of testKVPairs, which the workload picks from at random
+    vector<string> workloadKeys;
+    // wall-clock time the run started and the test KV pairs were inserted
+    chrono::steady_clock::time_point runStart;
+    chrono::steady_clock::time_point insertStart;
+    Random rng;
+    // first time every live node knew every other live node, -1 until then
+    int convergenceTime;
 
    public:
     Application(char *);
     virtual ~Application();
     Address getjoinaddr();
     void initTestKVPairs();
+    string randomString(int length);
+    string randomValue();
     int run();
     void mp1Run();
     void mp2Run();
     void fail();
     void insertTestKVPairs();
+    void workload();
+    void summary();
     int findARandomNodeThatIsAlive();
+    bool membershipConverged();
     void deleteTest();
     void readTest();
     void updateTest();
@@ -0,0 +1,314 @@
+/**********************************
+ * FILE NAME: Bench.cpp
+ *
+ * DESCRIPTION: Microbenchmarks of the core data paths
+ *
+ * RUN PROCEDURE:
+ * $ make bench
+ * $ ./Bench [--benchmark_filter=<regex>]
+ *
+ * Each benchmark takes a size argument: the value length for Message and
+ * Entry, the number of keys for HashTable, the ring size for findNodes, the
+ * number of entries for marshallEntries and the number of messages already
+ * in flight for EmulNet.
+ **********************************/
+
+#include <benchmark/benchmark.h>
+
+#include "EmulNet.h"
+#include "Entry.h"
+#include "HashTable.h"
+#include "Latency.h"
+#include "Log.h"
+#include "MP1Node.h"
+#include "MP2Node.h"
+#include "Message.h"
+#include "Params.h"
+#include "Random.h"
+
+/*
+ * Macros
+ */
+#define BENCH_KEY_LENGTH 5
+
+/**
+ * FUNCTION NAME: benchParams
+ *
+ * DESCRIPTION: Parameters of a run with nodes nodes and every key default
+ */
+static Params *benchParams(int nodes) {
+    Params *par = new Params();
+    par->setparams((char *)"/dev/null");
+    par->EN_GPSZ = nodes;
+    par->SEED = 1;
+    return par;
+}
+
+/**
+ * FUNCTION NAME: benchAddress
+ *
+ * DESCRIPTION: Address of node id, as ENinit hands it out
+ */
+static Address benchAddress(int id) {
+    Address addr;
+    addr.init();
+    memcpy(&addr.addr[0], &id, sizeof(int));
+    return addr;
+}
+
+/**
+ * FUNCTION NAME: benchKeys
+ *
+ * DESCRIPTION: count distinct random keys
+ */
+static vector<string> benchKeys(int count) {
+    static const char alphanum[] =
+        "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    Random rng;
+    vector<string> keys;
+    for (int i = 0; i < count; i++) {
+        string key = to_string(i) + "_";
+        for (int j = 0; j < BENCH_KEY_LENGTH; j++) {
+            key += alphanum[rng.nextInt(sizeof(alphanum) - 1)];
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+static void BM_MessageEncode(benchmark::State &state) {
+    Message m(1, benchAddress(1), CREATE, "key", string(state.range(0), 'v'),
+              PRIMARY);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.toString());
+    }
+}
+BENCHMARK(BM_MessageEncode)->RangeMultiplier(8)->Range(8, 4096);
+
+static void BM_MessageDecode(benchmark::State &state) {
+    Message m(1, benchAddress(1), CREATE, "key", string(state.range(0), 'v'),
+              PRIMARY);
+    string encoded = m.toString();
+    for (auto _ : state) {
+        Message decoded(encoded);
+        benchmark::DoNotOptimize(decoded.value);
+    }
+}
+BENCHMARK(BM_MessageDecode)->RangeMultiplier(8)->Range(8, 4096);
+
+static void BM_EntryEncode(benchmark::State &state) {
+    Entry e(string(state.range(0), 'v'), 1, PRIMARY);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(e.convertToString());
+    }
+}
+BENCHMARK(BM_EntryEncode)->RangeMultiplier(8)->Range(8, 4096);
+
+static void BM_EntryDecode(benchmark::State &state) {
+    string encoded = Entry(string(state.range(0), 'v'), 1, PRIMARY)
+                         .convertToString();
+    for (auto _ : state) {
+        Entry e(encoded);
+        benchmark::DoNotOptimize(e.value);
+    }
+}
+BENCHMARK(BM_EntryDecode)->RangeMultiplier(8)->Range(8, 4096);
+
+static void BM_HashTableCreate(benchmark::State &state) {
+    int size = state.range(0);
+    vector<string> keys = benchKeys(2 * size);
+    HashTable ht;
+    for (int i = 0; i < size; i++) ht.create(keys[i], "value");
+
+    // creates the absent half, and deletes it again untimed once all of it
+    // is present, so the table stays between size and 2 * size keys
+    int next = size;
+    for (auto _ : state) {
+        ht.create(keys[next], "value");
+        if (++next == 2 * size) {
+            state.PauseTiming();
+            for (int i = size; i < 2 * size; i++) ht.deleteKey(keys[i]);
+            next = size;
+            state.ResumeTiming();
+        }
+    }
+}
+BENCHMARK(BM_HashTableCreate)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+static void BM_HashTableRead(benchmark::State &state) {
+    int size = state.range(0);
+    vector<string> keys = benchKeys(size);
+    HashTable ht;
+    for (int i = 0; i < size; i++) ht.create(keys[i], "value");
+
+    int next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ht.read(keys[next]));
+        if (++next == size) next = 0;
+    }
+}
+BENCHMARK(BM_HashTableRead)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+static void BM_HashTableUpdate(benchmark::State &state) {
+    int size = state.range(0);
+    vector<string> keys = benchKeys(size);
+    HashTable ht;
+    for (int i = 0; i < size; i++) ht.create(keys[i], "value");
+
+    int next = 0;
+    for (auto _ : state) {
+        ht.update(keys[next], "newValue");
+        if (++next == size) next = 0;
+    }
+}
+BENCHMARK(BM_HashTableUpdate)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+static void BM_HashTableDelete(benchmark::State &state) {
+    int size = state.range(0);
+    vector<string> keys = benchKeys(2 * size);
+    HashTable ht;
+    for (int i = 0; i < 2 * size; i++) ht.create(keys[i], "value");
+
+    // deletes the second half, and creates it again untimed once all of it
+    // is gone
+    int next = size;
+    for (auto _ : state) {
+        ht.deleteKey(keys[next]);
+        if (++next == 2 * size) {
+            state.PauseTiming();
+            for (int i = size; i < 2 * size; i++) ht.create(keys[i], "value");
+            next = size;
+            state.ResumeTiming();
+        }
+    }
+}
+BENCHMARK(BM_HashTableDelete)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+static void BM_FindNodes(benchmark::State &state) {
+    int nodes = state.range(0);
+    unique_ptr<Params> par(benchParams(nodes));
+    Log log(par.get());
+    EmulNet en(par.get(), NULL, &MP2Node::trafficClass);
+    Latency latency;
+    Address self = benchAddress(1);
+
+    // the ring comes from the membership list
+    Member *member = new Member();
+    for (int id = 1; id <= nodes; id++) {
+        member->memberList.push_back(MemberListEntry(id, 0, 0, 0));
+    }
+    MP2Node node(member, par.get(), &en, &log, &latency, &self);
+    node.updateRing();
+
+    vector<string> keys = benchKeys(1024);
+    int next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(node.findNodes(keys[next]));
+        next = (next + 1) & 1023;
+    }
+}
+BENCHMARK(BM_FindNodes)->RangeMultiplier(8)->Range(8, 8192);
+
+/**
+ * CLASS NAME: MP1NodeBench
+ *
+ * DESCRIPTION: Reaches the private member list codec of MP1Node, whose friend
+ * 				it is
+ */
+class MP1NodeBench {
+   public:
+    static void sortEntries(vector<MemberListEntry> &m) {
+        MP1Node::sortEntries(m);
+    }
+    static size_t marshallEntries(char *dest, vector<MemberListEntry> &m,
+                                  size_t &next, size_t limit) {
+        return MP1Node::marshallEntries(dest, m, next, limit);
+    }
+    static void unmarshallEntries(MP1Node &node, char *src, size_t size,
+                                  vector<MemberListEntry> &m) {
+        node.unmarshallEntries(src, size, m);
+    }
+};
+
+/**
+ * FUNCTION NAME: benchEntries
+ *
+ * DESCRIPTION: count sorted entries with dense ids and close heartbeats, as
+ * 				in a converged membership list
+ */
+static vector<MemberListEntry> benchEntries(int count) {
+    Random rng;
+    vector<MemberListEntry> entries;
+    for (int id = 1; id <= count; id++) {
+        entries.push_back(MemberListEntry(id, 0, 1000 + rng.nextInt(20), 0));
+    }
+    MP1NodeBench::sortEntries(entries);
+    return entries;
+}
+
+static void BM_MarshallEntries(benchmark::State &state) {
+    vector<MemberListEntry> entries = benchEntries(state.range(0));
+    vector<char> buffer(entries.size() * MAX_ENCODED_FRAME_SIZE);
+    for (auto _ : state) {
+        size_t next = 0;
+        benchmark::DoNotOptimize(MP1NodeBench::marshallEntries(
+            buffer.data(), entries, next, buffer.size()));
+    }
+    state.SetItemsProcessed(state.iterations() * entries.size());
+}
+BENCHMARK(BM_MarshallEntries)->RangeMultiplier(8)->Range(8, 8192);
+
+static void BM_UnmarshallEntries(benchmark::State &state) {
+    unique_ptr<Params> par(benchParams(2));
+    Log log(par.get());
+    EmulNet en(par.get(), NULL, &MP1Node::trafficClass);
+    Address self = benchAddress(1);
+    Member member;
+    MP1Node node(&member, par.get(), &en, &log, &self);
+
+    vector<MemberListEntry> entries = benchEntries(state.range(0));
+    vector<char> buffer(entries.size() * MAX_ENCODED_FRAME_SIZE);
+    size_t next = 0;
+    size_t size = MP1NodeBench::marshallEntries(buffer.data(), entries, next,
+                                                buffer.size());
+
+    vector<MemberListEntry> decoded;
+    for (auto _ : state) {
+        decoded.clear();
+        MP1NodeBench::unmarshallEntries(node, buffer.data(), size, decoded);
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    state.SetItemsProcessed(state.iterations() * entries.size());
+}
+BENCHMARK(BM_UnmarshallEntries)->RangeMultiplier(8)->Range(8, 8192);
+
+static int dropWrapper(void *env, char *buff, int size) {
+    free(buff);
+    return 0;
+}
+
+/**
+ * FUNCTION NAME: BM_EmulNetSendRecv
+ *
+ * DESCRIPTION: One ENsend and the ENrecv that takes the message, with
+ * 				state.range(0) messages to another node left in flight
+ */
+static void BM_EmulNetSendRecv(benchmark::State &state) {
+    int inflight = state.range(0);
+    unique_ptr<Params> par(benchParams(3));
+    EmulNet en(par.get(), NULL, &MP1Node::trafficClass);
+    Address from = benchAddress(1), to = benchAddress(2),
+            bystander = benchAddress(3);
+    char data[64] = {0};
+
+    for (int i = 0; i < inflight; i++) {
+        en.ENsend(&from, &bystander, data, sizeof(data));
+    }
+    for (auto _ : state) {
+        en.ENsend(&from, &to, data, sizeof(data));
+        en.ENrecv(&to, dropWrapper, NULL, 1, NULL);
+    }
+}
+BENCHMARK(BM_EmulNetSendRecv)->Arg(0)->RangeMultiplier(8)->Range(8, 32768);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+#!/bin/bash
+
+#################################################
+# FILE NAME: ConvergenceBench.sh
+#
+# DESCRIPTION: Membership convergence time against group size
+#
+# RUN PROCEDURE:
+# $ chmod +x ConvergenceBench.sh
+# $ ./ConvergenceBench.sh [group sizes...]
+#
+# Each group size runs the membership protocol only (the KV store tests are
+# scheduled after the end of the run) and reports the first time at which
+# every node knew every other node. MAX_MSG_SIZE, SEED and PROTOCOL (GOSSIP or
+# SWIM) can be set in the environment, e.g.
+# PROTOCOL=SWIM MAX_MSG_SIZE=200 ./ConvergenceBench.sh 10 20
+# With FAIL_TIME set, nodes fail at that time (one node with SINGLE_FAILURE=1,
+# half of them otherwise) and DETECTED is the time of the last removal.
+# INTRODUCERS sets how many nodes answer join requests, and
+# JOIN_ANNOUNCE_FANOUT how many of their nodes they tell of joins.
+#################################################
+
+SIZES="${@:-10 20 40}"
+RUNNING_TIME=${RUNNING_TIME:-100}
+MAX_MSG_SIZE=${MAX_MSG_SIZE:-4000}
+SEED=${SEED:-1}
+PROTOCOL=${PROTOCOL:-GOSSIP}
+FAIL_TIME=${FAIL_TIME:--1}
+SINGLE_FAILURE=${SINGLE_FAILURE:-0}
+INTRODUCERS=${INTRODUCERS:-1}
+JOIN_ANNOUNCE_FANOUT=${JOIN_ANNOUNCE_FANOUT:-0}
+CONF=$(mktemp)
+
+make > /dev/null 2>&1
+if [ $? -ne 0 ]
+then
+    echo "COMPILATION ERROR !!!"
+    exit 1
+fi
+
+printf "%10s %12s %10s %10s %12s %10s\n" "NODES" "CONVERGED" "DETECTED" \
+    "MESSAGES" "BYTES" "WALL(s)"
+for n in ${SIZES}
+do
+    cat > "${CONF}" <<EOF
+NODE_COUNT: ${n}
+TOTAL_RUNNING_TIME: ${RUNNING_TIME}
+INSERT_TIME: $((RUNNING_TIME + 1))
+MAX_MSG_SIZE: ${MAX_MSG_SIZE}
+SEED: ${SEED}
+MEMBERSHIP_PROTOCOL: ${PROTOCOL}
+FAIL_TIME: ${FAIL_TIME}
+SINGLE_FAILURE: ${SINGLE_FAILURE}
+INTRODUCERS: ${INTRODUCERS}
+JOIN_ANNOUNCE_FANOUT: ${JOIN_ANNOUNCE_FANOUT}
+EOF
+    start=$(date +%s%N)
+    out=$(./Application "${CONF}")
+    end=$(date +%s%N)
+    converged=$(echo "${out}" | grep "Membership converged" | cut -d" " -f5)
+    messages=$(echo "${out}" | grep "Membership messages" | cut -d" " -f3)
+    bytes=$(echo "${out}" | grep "Membership messages" | cut -d" " -f5)
+    detected="-"
+    if [ "${FAIL_TIME}" -ge 0 ]
+    then
+        detected=$(grep "removed at time" dbg.log | awk '{print $NF}' | sort -n | tail -1)
+    fi
+    printf "%10s %12s %10s %10s %12s %7d.%02d\n" "${n}" "${converged:-never}" \
+        "${detected:-never}" "${messages}" "${bytes}" \
+        $(( (end - start) / 1000000000 )) $(( (end - start) / 10000000 % 100 ))
+done
+
+rm -f "${CONF}"
@@ -9,35 +9,49 @@
 /**
  * Constructor
  */
-EmulNet::EmulNet(Params *p) {
-    // trace.funcEntry("EmulNet::EmulNet");
-    int i, j;
+EmulNet::EmulNet(Params *p, Profiler *profiler, const TrafficClass *traffic) {
+    TRACE_SCOPE("EmulNet::EmulNet", 0);
     par = p;
+    this->profiler = profiler;
+    this->traffic = traffic;
+    trafficCounts.assign(traffic->types, TrafficCount());
     emulnet.setNextId(1);
-    emulnet.settCurrBuffSize(0);
+    // node ids start from 1, queue 0 takes messages to unknown ids
+    emulnet.queues.assign(par->EN_GPSZ + 1, vector<en_msg *>());
+    emulnet.inflight = 0;
     enInited = 0;
-    for (i = 0; i < MAX_NODES; i++) {
-        for (j = 0; j < MAX_TIME; j++) {
-            sent_msgs[i][j] = 0;
-            recv_msgs[i][j] = 0;
-        }
+    // node ids start from 1
+    sent_msgs.assign(par->EN_GPSZ + 1, vector<int>(par->TOTAL_RUNNING_TIME, 0));
+    recv_msgs.assign(par->EN_GPSZ + 1, vector<int>(par->TOTAL_RUNNING_TIME, 0));
+    for (int i = 0; i <= par->EN_GPSZ; i++) {
+        rngs.push_back(Random(par->SEED, traffic->stream, i));
     }
-    // trace.funcExit("EmulNet::EmulNet", SUCCESS);
+    dropped_full = 0;
+    dropped_random = 0;
+    dropped_oversize = 0;
+    peak_buffsize = 0;
+    total_msgs = 0;
+    total_bytes = 0;
 }
 
 /**
  * Copy constructor
  */
 EmulNet::EmulNet(EmulNet &anotherEmulNet) {
-    int i, j;
     this->par = anotherEmulNet.par;
+    this->profiler = anotherEmulNet.profiler;
+    this->traffic = anotherEmulNet.traffic;
+    this->trafficCounts = anotherEmulNet.trafficCounts;
     this->enInited = anotherEmulNet.enInited;
-    for (i = 0; i < MAX_NODES; i++) {
-        for (j = 0; j < MAX_TIME; j++) {
-            this->sent_msgs[i][j] = anotherEmulNet.sent_msgs[i][j];
-            this->recv_msgs[i][j] = anotherEmulNet.recv_msgs[i][j];
-        }
-    }
+    this->sent_msgs = anotherEmulNet.sent_msgs;
+    this->recv_msgs = anotherEmulNet.recv_msgs;
+    this->rngs = anotherEmulNet.rngs;
+    this->dropped_full = anotherEmulNet.dropped_full;
+    this->dropped_random = anotherEmulNet.dropped_random;
+    this->dropped_oversize = anotherEmulNet.dropped_oversize;
+    this->peak_buffsize = anotherEmulNet.peak_buffsize;
+    this->total_msgs = anotherEmulNet.total_msgs;
+    this->total_bytes = anotherEmulNet.total_bytes;
     this->emulnet = anotherEmulNet.emulnet;
 }
 
@@ -45,15 +59,20 @@ EmulNet::EmulNet(EmulNet &anotherEmulNet) {
  * Assignment operator overloading
  */
 EmulNet &EmulNet::operator=(EmulNet &anotherEmulNet) {
-    int i, j;
     this->par = anotherEmulNet.par;
+    this->profiler = anotherEmulNet.profiler;
+    this->traffic = anotherEmulNet.traffic;
+    this->trafficCounts = anotherEmulNet.trafficCounts;
     this->enInited = anotherEmulNet.enInited;
-    for (i = 0; i < MAX_NODES; i++) {
-        for (j = 0; j < MAX_TIME; j++) {
-            this->sent_msgs[i][j] = anotherEmulNet.sent_msgs[i][j];
-            this->recv_msgs[i][j] = anotherEmulNet.recv_msgs[i][j];
-        }
-    }
+    this->sent_msgs = anotherEmulNet.sent_msgs;
+    this->recv_msgs = anotherEmulNet.recv_msgs;
+    this->rngs = anotherEmulNet.rngs;
+    this->dropped_full = anotherEmulNet.dropped_full;
+    this->dropped_random = anotherEmulNet.dropped_random;
+    this->dropped_oversize = anotherEmulNet.dropped_oversize;
+    this->peak_buffsize = anotherEmulNet.peak_buffsize;
+    this->total_msgs = anotherEmulNet.total_msgs;
+    this->total_bytes = anotherEmulNet.total_bytes;
     this->emulnet = anotherEmulNet.emulnet;
     return *this;
 }
@@ -79,18 +98,42 @@ void *EmulNet::ENinit(Address *myaddr, short port) {
  * FUNCTION NAME: ENsend
  *
  * DESCRIPTION: EmulNet send function
+ * 				The message waits in the queue of its destination, which
+ * grows as needed. A message is only
+ * rejected when it is too large, when it is randomly dropped, or when the
+ * destination already has MAX_INFLIGHT_PER_NODE messages waiting. Each reason
+ * has its own counter.
  *
  * RETURNS:
- * size
+ * size, or 0 if the message was dropped
  */
 int EmulNet::ENsend(Address *myaddr, Address *toaddr, char *data, int size) {
     en_msg *em;
-    static char temp[2048];
-    int sendmsg = rand() % 100;
+    int src = *(int *)(myaddr->addr);
+    int dst = *(int *)(toaddr->addr);
+    ScopedTimer timer(profiler, PHASE_EN_SEND, src - 1);
 
-    if ((emulnet.currbuffsize >= ENBUFFSIZE) ||
-        (size + (int)sizeof(en_msg) >= par->MAX_MSG_SIZE) ||
-        (par->dropmsg && sendmsg < (int)(par->MSG_DROP_PROB * 100))) {
+    assert(src <= par->EN_GPSZ);
+
+    int sendmsg = rngs[src].nextInt(100);
+    TrafficCount &count = countOf(data, size);
+
+    if (size + (int)sizeof(en_msg) >= par->MAX_MSG_SIZE) {
+        dropped_oversize++;
+        count.droppedOversize++;
+        return 0;
+    }
+    if (par->dropmsg && sendmsg < (int)(par->MSG_DROP_PROB * 100)) {
+        dropped_random++;
+        count.droppedRandom++;
+        return 0;
+    }
+    if (dst < 1 || dst > par->EN_GPSZ) dst = 0;
+    vector<en_msg *> &waiting = emulnet.queues[dst];
+    if (par->MAX_INFLIGHT_PER_NODE > 0 && dst != 0 &&
+        (int)waiting.size() >= par->MAX_INFLIGHT_PER_NODE) {
+        dropped_full++;
+        count.droppedFull++;
         return 0;
     }
 
@@ -101,21 +144,21 @@ int EmulNet::ENsend(Address *myaddr, Address *toaddr, char *data, int size) {
     memcpy(&(em->to.addr), &(toaddr->addr), sizeof(em->from.addr));
     memcpy(em + 1, data, size);
 
-    emulnet.buff[emulnet.currbuffsize++] = em;
+    waiting.push_back(em);
+    emulnet.inflight++;
+    if (emulnet.getCurrBuffSize() > peak_buffsize) {
+        peak_buffsize = emulnet.getCurrBuffSize();
+    }
 
-    int src = *(int *)(myaddr->addr);
     int time = par->getcurrtime();
 
-    assert(src <= MAX_NODES);
-    assert(time < MAX_TIME);
+    assert(time < par->TOTAL_RUNNING_TIME);
 
     sent_msgs[src][time]++;
-
-#ifdef DEBUGLOG
-    sprintf(temp, "Sending 4+%d B msg type %d to %d.%d.%d.%d:%d ", size - 4,
-            *(int *)data, toaddr->addr[0], toaddr->addr[1], toaddr->addr[2],
-            toaddr->addr[3], *(short *)&toaddr->addr[4]);
-#endif
+    total_msgs++;
+    total_bytes += size;
+    count.sent++;
+    count.sentBytes += size;
 
     return size;
 }
@@ -140,6 +183,8 @@ int EmulNet::ENsend(Address *myaddr, Address *toaddr, string data) {
  * FUNCTION NAME: ENrecv
  *
  * DESCRIPTION: EmulNet receive function
+ * 				Hands every message waiting in the queue of myaddr to
+ * enq, oldest first, without looking at the messages of other nodes.
  *
  * RETURN:
  * 0
@@ -147,35 +192,35 @@ int EmulNet::ENsend(Address *myaddr, Address *toaddr, string data) {
 int EmulNet::ENrecv(Address *myaddr, int (*enq)(void *, char *, int),
                     struct timeval *t, int times, void *queue) {
     // times is always assumed to be 1
-    int i;
+    size_t i;
     char *tmp;
     int sz;
     en_msg *emsg;
+    int dst = *(int *)(myaddr->addr);
+    int time = par->getcurrtime();
+    ScopedTimer timer(profiler, PHASE_EN_RECV, dst - 1);
 
-    for (i = emulnet.currbuffsize - 1; i >= 0; i--) {
-        emsg = emulnet.buff[i];
-
-        if (0 == strcmp(emsg->to.addr, myaddr->addr)) {
-            sz = emsg->size;
-            tmp = (char *)malloc(sz * sizeof(char));
-            memcpy(tmp, (char *)(emsg + 1), sz);
-
-            emulnet.buff[i] = emulnet.buff[emulnet.currbuffsize - 1];
-            emulnet.currbuffsize--;
-
-            (*enq)(queue, (char *)tmp, sz);
+    assert(dst >= 1 && dst <= par->EN_GPSZ);
+    assert(time < par->TOTAL_RUNNING_TIME);
 
-            free(emsg);
+    vector<en_msg *> &waiting = emulnet.queues[dst];
+    for (i = 0; i < waiting.size(); i++) {
+        emsg = waiting[i];
+        sz = emsg->size;
+        tmp = (char *)malloc(sz * sizeof(char));
+        memcpy(tmp, (char *)(emsg + 1), sz);
 
-            int dst = *(int *)(myaddr->addr);
-            int time = par->getcurrtime();
+        TrafficCount &count = countOf(tmp, sz);
+        count.received++;
+        count.receivedBytes += sz;
 
-            assert(dst <= MAX_NODES);
-            assert(time < MAX_TIME);
+        (*enq)(queue, (char *)tmp, sz);
 
-            recv_msgs[dst][time]++;
-        }
+        free(emsg);
+        recv_msgs[dst][time]++;
     }
+    emulnet.inflight -= waiting.size();
+    waiting.clear();
 
     return 0;
 }
@@ -185,17 +230,22 @@ int EmulNet::ENrecv(Address *myaddr, int (*enq)(void *, char *, int),
  *
  * DESCRIPTION: Cleanup the EmulNet. Called exactly once at the end of the
  * program.
+ * 				Writes the counts of every node to file, msgcount.log,
+ * under the name of the layer, so the EmulNets of both layers can share it.
  */
-int EmulNet::ENcleanup() {
+int EmulNet::ENcleanup(FILE *file) {
     emulnet.nextid = 0;
     int i, j;
     int sent_total, recv_total;
 
-    FILE *file = fopen("msgcount.log", "w+");
-
-    while (emulnet.currbuffsize > 0) {
-        free(emulnet.buff[--emulnet.currbuffsize]);
+    for (auto &waiting : emulnet.queues) {
+        for (en_msg *emsg : waiting) free(emsg);
+        waiting.clear();
     }
+    emulnet.inflight = 0;
+
+    if (file == NULL) return 0;
+    fprintf(file, "layer %s\n", traffic->layer);
 
     for (i = 1; i <= par->EN_GPSZ; i++) {
         fprintf(file, "node %3d ", i);
@@ -220,6 +270,36 @@ int EmulNet::ENcleanup() {
                 sent_total, recv_total);
     }
 
-    fclose(file);
+    fprintf(file,
+            "dropped_full %d dropped_random %d dropped_oversize %d "
+            "peak_inflight %d\n",
+            dropped_full, dropped_random, dropped_oversize, peak_buffsize);
+
     return 0;
 }
+
+/**
+ * FUNCTION NAME: countOf
+ *
+ * DESCRIPTION: Traffic counts of the type of this message
+ */
+TrafficCount &EmulNet::countOf(const char *data, int size) {
+    int type = traffic->typeOf(data, size);
+    if (type < 0 || type >= traffic->types) type = traffic->types - 1;
+    return trafficCounts[type];
+}
+
+/**
+ * FUNCTION NAME: ENtraffic
+ *
+ * DESCRIPTION: Write a TRAFFIC_HEADER row per message type to file
+ */
+void EmulNet::ENtraffic(FILE *file) {
+    for (int t = 0; t < traffic->types; t++) {
+        const TrafficCount &c = trafficCounts[t];
+        fprintf(file, "%s,%s,%ld,%ld,%ld,%ld,%ld,%ld,%ld\n", traffic->layer,
+                traffic->names[t], c.sent, c.sentBytes, c.received,
+                c.receivedBytes, c.droppedFull, c.droppedRandom,
+                c.droppedOversize);
+    }
+}
@@ -7,16 +7,24 @@
 #ifndef _EMULNET_H_
 #define _EMULNET_H_
 
-#define MAX_NODES 1000
-#define MAX_TIME 3600
-#define ENBUFFSIZE 30000
-
 #include "Member.h"
 #include "Params.h"
+#include "Profiler.h"
+#include "Random.h"
+#include "Trace.h"
 #include "stdincludes.h"
 
 using namespace std;
 
+/*
+ * Macros
+ */
+#define MSGCOUNT_LOG "msgcount.log"
+#define TRAFFIC_LOG "traffic.csv"
+#define TRAFFIC_HEADER                                                 \
+    "layer,type,sent,sent_bytes,received,received_bytes,dropped_full," \
+    "dropped_random,dropped_oversize\n"
+
 /**
  * Struct Name: en_msg
  */
@@ -29,34 +37,63 @@ typedef struct en_msg {
     Address to;
 } en_msg;
 
+/**
+ * STRUCT NAME: TrafficClass
+ *
+ * DESCRIPTION: How the messages of the protocol on an EmulNet are told
+ * 				apart, for its per type traffic counts
+ */
+typedef struct TrafficClass {
+    // protocol name, the first column of traffic.csv
+    const char *layer;
+    int types;
+    const char *const *names;
+    // type of a message, from 0 to types - 1. The last type collects what
+    // typeOf cannot tell.
+    int (*typeOf)(const char *data, int size);
+    // Random stream of the drop and delay decisions, one per layer
+    RandomStream stream;
+} TrafficClass;
+
+/**
+ * STRUCT NAME: TrafficCount
+ *
+ * DESCRIPTION: Traffic of one message type, bytes are payload bytes
+ */
+typedef struct TrafficCount {
+    long sent;
+    long sentBytes;
+    long received;
+    long receivedBytes;
+    long droppedFull;
+    long droppedRandom;
+    long droppedOversize;
+} TrafficCount;
+
 /**
  * Class Name: EM
  */
 class EM {
    public:
     int nextid;
-    int currbuffsize;
     int firsteltindex;
-    en_msg *buff[ENBUFFSIZE];
-    EM() {}
+    // in-flight messages by destination id in arrival order, grow as needed.
+    // Messages to an id without a node wait in queue 0 until cleanup.
+    vector<vector<en_msg *>> queues;
+    // messages in all the queues
+    int inflight;
+    EM() : inflight(0) {}
     EM &operator=(EM &anotherEM) {
         this->nextid = anotherEM.getNextId();
-        this->currbuffsize = anotherEM.getCurrBuffSize();
         this->firsteltindex = anotherEM.getFirstEltIndex();
-        int i = this->currbuffsize;
-        while (i > 0) {
-            this->buff[i] = anotherEM.buff[i];
-            i--;
-        }
+        this->queues = anotherEM.queues;
+        this->inflight = anotherEM.inflight;
         return *this;
     }
     int getNextId() { return nextid; }
-    int getCurrBuffSize() { return currbuffsize; }
+    int getCurrBuffSize() { return inflight; }
     int getFirstEltIndex() { return firsteltindex; }
     void setNextId(int nextid) { this->nextid = nextid; }
-    void settCurrBuffSize(int currbuffsize) {
-        this->currbuffsize = currbuffsize;
-    }
     void setFirstEltIndex(int firsteltindex) {
         this->firsteltindex = firsteltindex;
     }
@@ -71,13 +108,32 @@ class EM {
 class EmulNet {
    private:
     Params *par;
-    int sent_msgs[MAX_NODES + 1][MAX_TIME];
-    int recv_msgs[MAX_NODES + 1][MAX_TIME];
+    // times ENsend and ENrecv, may be NULL
+    Profiler *profiler;
+    // per node, per time unit message counters
+    vector<vector<int>> sent_msgs;
+    vector<vector<int>> recv_msgs;
+    // per node random streams for the drop decision
+    vector<Random> rngs;
+    // messages rejected by ENsend, by reason
+    int dropped_full;
+    int dropped_random;
+    int dropped_oversize;
+    // per message type counts
+    const TrafficClass *traffic;
+    vector<TrafficCount> trafficCounts;
+    // largest number of messages in flight at once
+    int peak_buffsize;
+    // totals over all accepted messages
+    long total_msgs;
+    long total_bytes;
     int enInited;
     EM emulnet;
 
+    TrafficCount &countOf(const char *data, int size);
+
    public:
-    EmulNet(Params *p);
+    EmulNet(Params *p, Profiler *profiler, const TrafficClass *traffic);
     EmulNet(EmulNet &anotherEmulNet);
     EmulNet &operator=(EmulNet &anotherEmulNet);
     virtual ~EmulNet();
@@ -86,7 +142,13 @@ class EmulNet {
     int ENsend(Address *myaddr, Address *toaddr, char *data, int size);
     int ENrecv(Address *myaddr, int (*enq)(void *, char *, int),
                struct timeval *t, int times, void *queue);
-    int ENcleanup();
+    int ENcleanup(FILE *file);
+    void ENtraffic(FILE *file);
+    int getDroppedFull() { return dropped_full; }
+    int getDroppedRandom() { return dropped_random; }
+    int getDroppedOversize() { return dropped_oversize; }
+    long getTotalMsgs() { return total_msgs; }
+    long getTotalBytes() { return total_bytes; }
 };
 
 #endif /* _EMULNET_H_ */
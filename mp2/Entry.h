@@ -4,6 +4,9 @@
  * DESCRIPTION: Header file Entry class
  **********************************/
 
+#ifndef ENTRY_H_
+#define ENTRY_H_
+
 #include "Message.h"
 #include "stdincludes.h"
 
@@ -23,3 +26,5 @@ class Entry {
     Entry(string _value, int _timestamp, ReplicaType _replica);
     string convertToString();
 };
+
+#endif /* ENTRY_H_ */
@@ -0,0 +1,79 @@
+/**********************************
+ * FILE NAME: EventLog.h
+ *
+ * DESCRIPTION: Record layout of the binary event log
+ **********************************/
+
+#ifndef _EVENTLOG_H_
+#define _EVENTLOG_H_
+
+#include <stdint.h>
+
+/*
+ * Macros
+ */
+#define DBG_BIN "dbg.bin"
+#define EVENT_LOG_MAGIC "CS425EVT"
+#define EVENT_LOG_VERSION 2
+// flags of an EventRecord
+#define EVENT_COORDINATOR 1
+#define EVENT_STATS 2
+// the first line of the run, which has no node address in text
+#define EVENT_FIRST 4
+
+/**
+ * Kinds of records in the event log
+ */
+enum EventType {
+    // defines string key, transID bytes of it follow the record
+    EVENT_STRING,
+    // free text passed to Log::LOG, value is its string
+    EVENT_TEXT,
+    // key holds the id bytes and value the port of the other node
+    EVENT_NODE_ADD,
+    EVENT_NODE_REMOVE,
+    // key and value are strings
+    EVENT_CREATE_SUCCESS,
+    EVENT_READ_SUCCESS,
+    EVENT_UPDATE_SUCCESS,
+    EVENT_DELETE_SUCCESS,
+    EVENT_CREATE_FAIL,
+    EVENT_READ_FAIL,
+    EVENT_UPDATE_FAIL,
+    EVENT_DELETE_FAIL,
+    DUMMYLASTEVENTTYPE
+};
+
+/**
+ * STRUCT NAME: EventLogHeader
+ *
+ * DESCRIPTION: Start of dbg.bin
+ */
+typedef struct EventLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+} EventLogHeader;
+
+/**
+ * STRUCT NAME: EventRecord
+ *
+ * DESCRIPTION: One line of dbg.log or stats.log
+ * 				Keys and values are not stored in the record. Each
+ * distinct one is written once as an EVENT_STRING and then referenced by
+ * id, rather than by a hash, so the renderer can print it back.
+ */
+typedef struct EventRecord {
+    int32_t time;
+    int32_t transID;
+    uint32_t key;
+    uint32_t value;
+    // address of the node that logged it
+    uint8_t node[6];
+    uint8_t type;
+    uint8_t flags;
+} EventRecord;
+
+static_assert(sizeof(EventRecord) == 24, "EventRecord is written as is");
+
+#endif /* _EVENTLOG_H_ */
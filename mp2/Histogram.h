@@ -0,0 +1,107 @@
+/**********************************
+ * FILE NAME: Histogram.h
+ *
+ * DESCRIPTION: Header file for the log-linear value histogram
+ **********************************/
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include "stdincludes.h"
+
+/**
+ * Macros
+ */
+// each power of two is split into 2^HISTOGRAM_SUB_BITS / 2 buckets, so a
+// recorded value is off by at most 1 / 2^(HISTOGRAM_SUB_BITS - 1), about 3%
+#define HISTOGRAM_SUB_BITS 5
+
+/**
+ * CLASS NAME: Histogram
+ *
+ * DESCRIPTION: Counts of non-negative values in HdrHistogram style buckets.
+ * Values below 2^HISTOGRAM_SUB_BITS get a bucket each, and above that every
+ * power of two gets the same number of buckets, so recording is a shift and
+ * an increment and the relative error is bounded at any magnitude.
+ * Percentiles report the highest value of the bucket they fall in.
+ */
+class Histogram {
+   private:
+    vector<uint64_t> counts;
+    uint64_t total;
+    long long sum;
+    long long minValue;
+    long long maxValue;
+
+    static int msb(unsigned long long v) {
+        int bit = -1;
+        while (v) {
+            v >>= 1;
+            bit++;
+        }
+        return bit;
+    }
+    static size_t bucketOf(long long v) {
+        const long long sub = 1LL << HISTOGRAM_SUB_BITS;
+        if (v < sub) return (size_t)v;
+        int shift = msb(v) - (HISTOGRAM_SUB_BITS - 1);
+        return (size_t)(shift * (sub / 2) + (v >> shift));
+    }
+    // highest value that falls in bucket b
+    static long long highestIn(size_t b) {
+        const size_t sub = (size_t)1 << HISTOGRAM_SUB_BITS;
+        if (b < sub) return (long long)b;
+        int shift = (int)((b - sub / 2) / (sub / 2));
+        long long top = (long long)(b - shift * (sub / 2));
+        return ((top + 1) << shift) - 1;
+    }
+
+   public:
+    Histogram() : total(0), sum(0), minValue(0), maxValue(0) {}
+    void record(long long v) {
+        if (v < 0) v = 0;
+        size_t b = bucketOf(v);
+        if (b >= counts.size()) counts.resize(b + 1, 0);
+        counts[b]++;
+        if (total == 0 || v < minValue) minValue = v;
+        if (total == 0 || v > maxValue) maxValue = v;
+        total++;
+        sum += v;
+    }
+    void add(const Histogram &other) {
+        if (other.counts.size() > counts.size()) {
+            counts.resize(other.counts.size(), 0);
+        }
+        for (size_t b = 0; b < other.counts.size(); b++) {
+            counts[b] += other.counts[b];
+        }
+        if (other.total > 0) {
+            if (total == 0 || other.minValue < minValue) {
+                minValue = other.minValue;
+            }
+            if (total == 0 || other.maxValue > maxValue) {
+                maxValue = other.maxValue;
+            }
+        }
+        total += other.total;
+        sum += other.sum;
+    }
+    uint64_t count() const { return total; }
+    long long min() const { return minValue; }
+    long long max() const { return maxValue; }
+    double mean() const { return total ? (double)sum / total : 0; }
+    // smallest recorded value that percent of the values are at or below
+    long long percentile(double percent) const {
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t)ceil(percent / 100 * total);
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < counts.size(); b++) {
+            seen += counts[b];
+            if (seen >= rank) return std::min(highestIn(b), maxValue);
+        }
+        return maxValue;
+    }
+};
+
+#endif /* HISTOGRAM_H_ */
@@ -0,0 +1,90 @@
+/**********************************
+ * FILE NAME: Latency.cpp
+ *
+ * DESCRIPTION: Latency class definition
+ **********************************/
+
+#include "Latency.h"
+
+static const char *opNames[LATENCY_OPS] = {"CREATE", "READ", "UPDATE",
+                                           "DELETE"};
+
+/**
+ * Constructor
+ */
+Latency::Latency() {
+    memset(started, 0, sizeof(started));
+    memset(failed, 0, sizeof(failed));
+}
+
+/**
+ * FUNCTION NAME: start
+ *
+ * DESCRIPTION: count an operation sent to its replicas
+ */
+void Latency::start(int type) {
+    if (type >= 0 && type < LATENCY_OPS) started[type]++;
+}
+
+/**
+ * FUNCTION NAME: finish
+ *
+ * DESCRIPTION: record an operation that reached or missed its quorum
+ * 				elapsed time units after it was sent
+ */
+void Latency::finish(int type, int elapsed, bool success) {
+    if (type < 0 || type >= LATENCY_OPS) return;
+    ticks[type].record(elapsed);
+    if (!success) failed[type]++;
+}
+
+/**
+ * FUNCTION NAME: decided
+ *
+ * DESCRIPTION: number of operations of every type that reached or missed
+ * 				their quorum
+ */
+long Latency::decided() {
+    long count = 0;
+    for (int op = 0; op < LATENCY_OPS; op++) count += ticks[op].count();
+    return count;
+}
+
+/**
+ * FUNCTION NAME: dumpRow
+ *
+ * DESCRIPTION: write one line of latency.log
+ */
+static void dumpRow(FILE *file, const char *name, const Histogram &h,
+                    int started, int failed) {
+    fprintf(file, "%-6s %7llu %7d %7lld %5lld %5lld %5lld %5lld %5lld %7.2f\n",
+            name, (unsigned long long)h.count(), failed,
+            (long long)started - (long long)h.count(), h.min(),
+            h.percentile(50), h.percentile(99), h.percentile(99.9), h.max(),
+            h.mean());
+}
+
+/**
+ * FUNCTION NAME: dump
+ *
+ * DESCRIPTION: write the percentiles of every operation type to path
+ */
+void Latency::dump(const char *path) {
+    FILE *file = fopen(path, "w+");
+    if (file == NULL) return;
+
+    Histogram all;
+    int allStarted = 0, allFailed = 0;
+
+    fprintf(file, "%-6s %7s %7s %7s %5s %5s %5s %5s %5s %7s\n", "op", "count",
+            "failed", "pending", "min", "p50", "p99", "p999", "max", "mean");
+    for (int op = 0; op < LATENCY_OPS; op++) {
+        dumpRow(file, opNames[op], ticks[op], started[op], failed[op]);
+        all.add(ticks[op]);
+        allStarted += started[op];
+        allFailed += failed[op];
+    }
+    dumpRow(file, "ALL", all, allStarted, allFailed);
+
+    fclose(file);
+}
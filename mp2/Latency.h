@@ -0,0 +1,42 @@
+/**********************************
+ * FILE NAME: Latency.h
+ *
+ * DESCRIPTION: Header file of Latency class
+ **********************************/
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include "Histogram.h"
+#include "stdincludes.h"
+
+/*
+ * Macros
+ */
+#define LATENCY_LOG "latency.log"
+// operation types tracked, the MessageType values CREATE to DELETE
+#define LATENCY_OPS 4
+
+/**
+ * CLASS NAME: Latency
+ *
+ * DESCRIPTION: Latency of the client CRUD operations of all the nodes
+ * 				An operation is timed from the coordinator sending it to
+ * the replicas until it reaches or misses its quorum, in simulated time
+ * units. Operations that never decide are counted as pending.
+ */
+class Latency {
+   private:
+    Histogram ticks[LATENCY_OPS];
+    int started[LATENCY_OPS];
+    int failed[LATENCY_OPS];
+
+   public:
+    Latency();
+    void start(int type);
+    void finish(int type, int elapsed, bool success);
+    long decided();
+    void dump(const char *path);
+};
+
+#endif /* LATENCY_H_ */
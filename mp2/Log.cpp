@@ -6,102 +6,199 @@
 
 #include "Log.h"
 
+/**
+ * Per-thread buffers, a line is formatted in the thread that logs it
+ */
+static thread_local char formatBuffer[LOG_LINE_SIZE];
+static thread_local char lineBuffer[LOG_LINE_SIZE + 100];
+static thread_local string recordBuffer;
+
 /**
  * Constructor
  */
-Log::Log(Params *p) {
-    par = p;
-    firstTime = false;
-}
+Log::Log(Params *p) : firstTaken(false), nextString(0) { par = p; }
 
 /**
- * Copy constructor
+ * Destructor
  */
-Log::Log(const Log &anotherLog) {
-    this->par = anotherLog.par;
-    this->firstTime = anotherLog.firstTime;
-}
+Log::~Log() {}
 
 /**
- * Assignment Operator Overloading
+ * FUNCTION NAME: open
+ *
+ * DESCRIPTION: create the log files the first time any thread logs
+ * 				dbg.log starts with the magic number, dbg.bin with its
+ * header. Nothing can be appended before, since every thread waits here
+ * until the first one is done.
  */
-Log &Log::operator=(const Log &anotherLog) {
-    this->par = anotherLog.par;
-    this->firstTime = anotherLog.firstTime;
-    return *this;
+void Log::open() {
+    call_once(opened, [this]() {
+        if (par->BINARY_LOG) {
+            eventWriter.reset(new LogWriter(DBG_BIN));
+
+            EventLogHeader header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic));
+            header.version = EVENT_LOG_VERSION;
+            header.recordSize = sizeof(EventRecord);
+            eventWriter->append((char *)&header, sizeof(header));
+            return;
+        }
+
+        dbgWriter.reset(new LogWriter(DBG_LOG));
+        statsWriter.reset(new LogWriter(STATS_LOG));
+
+        int magicNumber = 0;
+        string magic = MAGIC_NUMBER;
+        int len = magic.length();
+        for (int i = 0; i < len; i++) {
+            magicNumber += (int)magic.at(i);
+        }
+        char line[16];
+        int size = sprintf(line, "%x\n", magicNumber);
+        dbgWriter->append(line, size);
+    });
 }
 
 /**
- * Destructor
+ * FUNCTION NAME: takeFirst
+ *
+ * DESCRIPTION: whether this is the first line of the run, which goes out
+ * without the address of its node
  */
-Log::~Log() {}
+bool Log::takeFirst() {
+    return !firstTaken.load(memory_order_relaxed) &&
+           !firstTaken.exchange(true, memory_order_relaxed);
+}
 
 /**
  * FUNCTION NAME: LOG
  *
  * DESCRIPTION: Print out to file dbg.log, along with Address of node.
+ * 				Lines are handed to a LogWriter per file, which writes
+ * them from a background thread in large batches instead of flushing every
+ * line.
  */
 void Log::LOG(Address *addr, const char *str, ...) {
-    static FILE *fp;
-    static FILE *fp2;
     va_list vararglist;
-    static char buffer[30000];
-    static int numwrites;
-    static char stdstring[30];
-    static char stdstring2[40];
-    static char stdstring3[40];
-    static int dbg_opened = 0;
+    va_start(vararglist, str);
+    vsnprintf(formatBuffer, sizeof(formatBuffer), str, vararglist);
+    va_end(vararglist);
+    bool stats = memcmp(formatBuffer, "#STATSLOG#", 10) == 0;
 
-    if (dbg_opened != 639) {
-        numwrites = 0;
+    // dbg.bin replaces both text files
+    if (par->BINARY_LOG) {
+        logEvent(addr, EVENT_TEXT, stats ? EVENT_STATS : 0, 0, 0,
+                 putString(formatBuffer, false));
+        return;
+    }
 
-        stdstring2[0] = 0;
+    open();
+    char stdstring[30] = "";
+    if (!takeFirst()) {
+        sprintf(stdstring, "%d.%d.%d.%d:%d ", addr->addr[0], addr->addr[1],
+                addr->addr[2], addr->addr[3], *(short *)&addr->addr[4]);
+    }
 
-        strcpy(stdstring3, stdstring2);
+    int size = snprintf(lineBuffer, sizeof(lineBuffer), "\n %s[%d] %s",
+                        stdstring, par->getcurrtime(), formatBuffer);
+    size = min(size, (int)sizeof(lineBuffer) - 1);
 
-        strcat(stdstring2, DBG_LOG);
-        strcat(stdstring3, STATS_LOG);
+    if (stats) {
+        statsWriter->append(lineBuffer, size);
+    } else {
+        dbgWriter->append(lineBuffer, size);
+    }
+}
 
-        fp = fopen(stdstring2, "w");
-        fp2 = fopen(stdstring3, "w");
+/**
+ * FUNCTION NAME: putString
+ *
+ * DESCRIPTION: id of s in dbg.bin, written there as an EVENT_STRING unless
+ * it already was
+ * 				Keys and values are interned, free text is written
+ * every time since it hardly ever repeats. A new string is written while
+ * its stripe is locked, so no thread can log its id ahead of it.
+ */
+uint32_t Log::putString(const string &s, bool intern) {
+    if (!intern) return defineString(s);
 
-        dbg_opened = 639;
-    } else
+    auto &stripe = stringStripes[hash<string>()(s) % LOG_STRING_STRIPES];
+    lock_guard<mutex> guard(stripe.lock);
+    auto it = stripe.ids.find(s);
+    if (it != stripe.ids.end()) return it->second;
 
-        sprintf(stdstring, "%d.%d.%d.%d:%d ", addr->addr[0], addr->addr[1],
-                addr->addr[2], addr->addr[3], *(short *)&addr->addr[4]);
+    uint32_t id = defineString(s);
+    stripe.ids[s] = id;
+    return id;
+}
 
-    va_start(vararglist, str);
-    vsprintf(buffer, str, vararglist);
-    va_end(vararglist);
+/**
+ * FUNCTION NAME: defineString
+ *
+ * DESCRIPTION: write s to dbg.bin under a new id
+ */
+uint32_t Log::defineString(const string &s) {
+    open();
 
-    if (!firstTime) {
-        int magicNumber = 0;
-        string magic = MAGIC_NUMBER;
-        int len = magic.length();
-        for (int i = 0; i < len; i++) {
-            magicNumber += (int)magic.at(i);
-        }
-        fprintf(fp, "%x\n", magicNumber);
-        firstTime = true;
-    }
+    EventRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.type = EVENT_STRING;
+    rec.transID = s.size();
+    rec.key = nextString.fetch_add(1, memory_order_relaxed);
 
-    if (memcmp(buffer, "#STATSLOG#", 10) == 0) {
-        fprintf(fp2, "\n %s", stdstring);
-        fprintf(fp2, "[%d] ", par->getcurrtime());
+    // record and bytes in one append, so no other line gets between them
+    recordBuffer.assign((char *)&rec, sizeof(rec));
+    recordBuffer.append(s);
+    eventWriter->append(recordBuffer.data(), recordBuffer.size());
+    return rec.key;
+}
 
-        fprintf(fp2, buffer);
-    } else {
-        fprintf(fp, "\n %s", stdstring);
-        fprintf(fp, "[%d] ", par->getcurrtime());
-        fprintf(fp, buffer);
-    }
+/**
+ * FUNCTION NAME: logEvent
+ *
+ * DESCRIPTION: append one record to dbg.bin
+ */
+void Log::logEvent(Address *addr, EventType type, uint8_t flags, int transID,
+                   uint32_t key, uint32_t value) {
+    open();
 
-    if (++numwrites >= MAXWRITES) {
-        fflush(fp);
-        fflush(fp2);
-        numwrites = 0;
-    }
+    EventRecord rec;
+    rec.time = par->getcurrtime();
+    rec.transID = transID;
+    rec.key = key;
+    rec.value = value;
+    memcpy(rec.node, addr->addr, sizeof(rec.node));
+    rec.type = type;
+    rec.flags = flags | (takeFirst() ? EVENT_FIRST : 0);
+    eventWriter->append((char *)&rec, sizeof(rec));
+}
+
+/**
+ * FUNCTION NAME: logKeyEvent
+ *
+ * DESCRIPTION: append a CRUD outcome to dbg.bin, value is NULL for the ones
+ * logged without it
+ */
+void Log::logKeyEvent(Address *addr, EventType type, bool isCoordinator,
+                      int transID, const string &key, const string *value) {
+    uint32_t keyId = putString(key, true);
+    uint32_t valueId = value ? putString(*value, true) : 0;
+    logEvent(addr, type, isCoordinator ? EVENT_COORDINATOR : 0, transID, keyId,
+             valueId);
+}
+
+/**
+ * FUNCTION NAME: logNodeEvent
+ *
+ * DESCRIPTION: append a join or removal of other to dbg.bin
+ */
+void Log::logNodeEvent(Address *thisNode, EventType type, Address *other) {
+    uint32_t id;
+    uint16_t port;
+    memcpy(&id, other->addr, sizeof(id));
+    memcpy(&port, &other->addr[4], sizeof(port));
+    logEvent(thisNode, type, 0, 0, id, port);
 }
 
 /**
@@ -110,12 +207,14 @@ void Log::LOG(Address *addr, const char *str, ...) {
  * DESCRIPTION: To Log a node add
  */
 void Log::logNodeAdd(Address *thisNode, Address *addedAddr) {
-    static char stdstring[100];
-    sprintf(stdstring, "Node %d.%d.%d.%d:%d joined at time %d",
-            addedAddr->addr[0], addedAddr->addr[1], addedAddr->addr[2],
-            addedAddr->addr[3], *(short *)&addedAddr->addr[4],
-            par->getcurrtime());
-    LOG(thisNode, stdstring);
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_MEMBERSHIP)) return;
+    if (par->BINARY_LOG) {
+        logNodeEvent(thisNode, EVENT_NODE_ADD, addedAddr);
+        return;
+    }
+    LOG(thisNode, "Node %d.%d.%d.%d:%d joined at time %d", addedAddr->addr[0],
+        addedAddr->addr[1], addedAddr->addr[2], addedAddr->addr[3],
+        *(short *)&addedAddr->addr[4], par->getcurrtime());
 }
 
 /**
@@ -124,12 +223,15 @@ void Log::logNodeAdd(Address *thisNode, Address *addedAddr) {
  * DESCRIPTION: To log a node remove
  */
 void Log::logNodeRemove(Address *thisNode, Address *removedAddr) {
-    static char stdstring[30];
-    sprintf(stdstring, "Node %d.%d.%d.%d:%d removed at time %d",
-            removedAddr->addr[0], removedAddr->addr[1], removedAddr->addr[2],
-            removedAddr->addr[3], *(short *)&removedAddr->addr[4],
-            par->getcurrtime());
-    LOG(thisNode, stdstring);
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_MEMBERSHIP)) return;
+    if (par->BINARY_LOG) {
+        logNodeEvent(thisNode, EVENT_NODE_REMOVE, removedAddr);
+        return;
+    }
+    LOG(thisNode, "Node %d.%d.%d.%d:%d removed at time %d",
+        removedAddr->addr[0], removedAddr->addr[1], removedAddr->addr[2],
+        removedAddr->addr[3], *(short *)&removedAddr->addr[4],
+        par->getcurrtime());
 }
 
 /**
@@ -138,18 +240,20 @@ void Log::logNodeRemove(Address *thisNode, Address *removedAddr) {
  * DESCRTION: Call this function after successfully create a key value pair
  */
 void Log::logCreateSuccess(Address *address, bool isCoordinator, int transID,
-                           string key, string value) {
-    static char stdstring[100];
+                           const string &key, const string &value) {
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_KVSTORE)) return;
+    if (par->BINARY_LOG) {
+        logKeyEvent(address, EVENT_CREATE_SUCCESS, isCoordinator, transID, key,
+                    &value);
+        return;
+    }
     string str;
     if (isCoordinator)
         str = "coordinator";
     else
         str = "server";
-    sprintf(stdstring,
-            "%s: create success at time %d, transID=%d, key=%s, value=%s",
-            str.c_str(), par->getcurrtime(), transID, key.c_str(),
-            value.c_str());
-    LOG(address, stdstring);
+    LOG(address, "%s: create success at time %d, transID=%d, key=%s, value=%s",
+        str.c_str(), par->getcurrtime(), transID, key.c_str(), value.c_str());
 }
 
 /**
@@ -158,17 +262,20 @@ void Log::logCreateSuccess(Address *address, bool isCoordinator, int transID,
  * DESCRIPTION: Call this function after successfully reading a key
  */
 void Log::logReadSuccess(Address *address, bool isCoordinator, int transID,
-                         string key, string value) {
-    static char stdstring[100];
+                         const string &key, const string &value) {
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_KVSTORE)) return;
+    if (par->BINARY_LOG) {
+        logKeyEvent(address, EVENT_READ_SUCCESS, isCoordinator, transID, key,
+                    &value);
+        return;
+    }
     string str;
     if (isCoordinator)
         str = "coordinator";
     else
         str = "server";
-    sprintf(
-        stdstring, "%s: read success at time %d, transID=%d, key=%s, value=%s",
+    LOG(address, "%s: read success at time %d, transID=%d, key=%s, value=%s",
         str.c_str(), par->getcurrtime(), transID, key.c_str(), value.c_str());
-    LOG(address, stdstring);
 }
 
 /**
@@ -177,18 +284,21 @@ void Log::logReadSuccess(Address *address, bool isCoordinator, int transID,
  * DESCRIPTION: Call this function after successfully updating a key
  */
 void Log::logUpdateSuccess(Address *address, bool isCoordinator, int transID,
-                           string key, string newValue) {
-    static char stdstring[100];
+                           const string &key, const string &newValue) {
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_KVSTORE)) return;
+    if (par->BINARY_LOG) {
+        logKeyEvent(address, EVENT_UPDATE_SUCCESS, isCoordinator, transID, key,
+                    &newValue);
+        return;
+    }
     string str;
     if (isCoordinator)
         str = "coordinator";
     else
         str = "server";
-    sprintf(stdstring,
-            "%s: update success at time %d, transID=%d, key=%s, value=%s",
-            str.c_str(), par->getcurrtime(), transID, key.c_str(),
-            newValue.c_str());
-    LOG(address, stdstring);
+    LOG(address, "%s: update success at time %d, transID=%d, key=%s, value=%s",
+        str.c_str(), par->getcurrtime(), transID, key.c_str(),
+        newValue.c_str());
 }
 
 /**
@@ -197,16 +307,20 @@ void Log::logUpdateSuccess(Address *address, bool isCoordinator, int transID,
  * DESCRIPTION: Call this function after successfully deleting a key
  */
 void Log::logDeleteSuccess(Address *address, bool isCoordinator, int transID,
-                           string key) {
-    static char stdstring[100];
+                           const string &key) {
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_KVSTORE)) return;
+    if (par->BINARY_LOG) {
+        logKeyEvent(address, EVENT_DELETE_SUCCESS, isCoordinator, transID, key,
+                    NULL);
+        return;
+    }
     string str;
     if (isCoordinator)
         str = "coordinator";
     else
         str = "server";
-    sprintf(stdstring, "%s: delete success at time %d, transID=%d, key=%s",
-            str.c_str(), par->getcurrtime(), transID, key.c_str());
-    LOG(address, stdstring);
+    LOG(address, "%s: delete success at time %d, transID=%d, key=%s",
+        str.c_str(), par->getcurrtime(), transID, key.c_str());
 }
 
 /**
@@ -215,17 +329,20 @@ void Log::logDeleteSuccess(Address *address, bool isCoordinator, int transID,
  * DESCRIPTION: Call this function if CREATE failed
  */
 void Log::logCreateFail(Address *address, bool isCoordinator, int transID,
-                        string key, string value) {
-    static char stdstring[100];
+                        const string &key, const string &value) {
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_KVSTORE)) return;
+    if (par->BINARY_LOG) {
+        logKeyEvent(address, EVENT_CREATE_FAIL, isCoordinator, transID, key,
+                    &value);
+        return;
+    }
     string str;
     if (isCoordinator)
         str = "coordinator";
     else
         str = "server";
-    sprintf(
-        stdstring, "%s: create fail at time %d, transID=%d, key=%s, value=%s",
+    LOG(address, "%s: create fail at time %d, transID=%d, key=%s, value=%s",
         str.c_str(), par->getcurrtime(), transID, key.c_str(), value.c_str());
-    LOG(address, stdstring);
 }
 
 /**
@@ -234,16 +351,20 @@ void Log::logCreateFail(Address *address, bool isCoordinator, int transID,
  * DESCRIPTION: Call this function if READ failed
  */
 void Log::logReadFail(Address *address, bool isCoordinator, int transID,
-                      string key) {
-    static char stdstring[100];
+                      const string &key) {
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_KVSTORE)) return;
+    if (par->BINARY_LOG) {
+        logKeyEvent(address, EVENT_READ_FAIL, isCoordinator, transID, key,
+                    NULL);
+        return;
+    }
     string str;
     if (isCoordinator)
         str = "coordinator";
     else
         str = "server";
-    sprintf(stdstring, "%s: read fail at time %d, transID=%d, key=%s",
-            str.c_str(), par->getcurrtime(), transID, key.c_str());
-    LOG(address, stdstring);
+    LOG(address, "%s: read fail at time %d, transID=%d, key=%s",
+        str.c_str(), par->getcurrtime(), transID, key.c_str());
 }
 
 /**
@@ -252,18 +373,21 @@ void Log::logReadFail(Address *address, bool isCoordinator, int transID,
  * DESCRIPTION: Call this function if UPDATE failed
  */
 void Log::logUpdateFail(Address *address, bool isCoordinator, int transID,
-                        string key, string newValue) {
-    static char stdstring[100];
+                        const string &key, const string &newValue) {
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_KVSTORE)) return;
+    if (par->BINARY_LOG) {
+        logKeyEvent(address, EVENT_UPDATE_FAIL, isCoordinator, transID, key,
+                    &newValue);
+        return;
+    }
     string str;
     if (isCoordinator)
         str = "coordinator";
     else
         str = "server";
-    sprintf(stdstring,
-            "%s: update fail at time %d, transID=%d, key=%s, value=%s",
-            str.c_str(), par->getcurrtime(), transID, key.c_str(),
-            newValue.c_str());
-    LOG(address, stdstring);
+    LOG(address, "%s: update fail at time %d, transID=%d, key=%s, value=%s",
+        str.c_str(), par->getcurrtime(), transID, key.c_str(),
+        newValue.c_str());
 }
 
 /**
@@ -272,14 +396,18 @@ void Log::logUpdateFail(Address *address, bool isCoordinator, int transID,
  * DESCRIPTION: Call this function if DELETE failed
  */
 void Log::logDeleteFail(Address *address, bool isCoordinator, int transID,
-                        string key) {
-    static char stdstring[100];
+                        const string &key) {
+    if (!LOG_ENABLED(this, LOG_LEVEL_INFO, LOG_KVSTORE)) return;
+    if (par->BINARY_LOG) {
+        logKeyEvent(address, EVENT_DELETE_FAIL, isCoordinator, transID, key,
+                    NULL);
+        return;
+    }
     string str;
     if (isCoordinator)
         str = "coordinator";
     else
         str = "server";
-    sprintf(stdstring, "%s: delete fail at time %d, transID=%d, key=%s",
-            str.c_str(), par->getcurrtime(), transID, key.c_str());
-    LOG(address, stdstring);
+    LOG(address, "%s: delete fail at time %d, transID=%d, key=%s",
+        str.c_str(), par->getcurrtime(), transID, key.c_str());
 }
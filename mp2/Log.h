@@ -7,6 +7,13 @@
 #ifndef _LOG_H_
 #define _LOG_H_
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "EventLog.h"
+#include "LogWriter.h"
 #include "Member.h"
 #include "Params.h"
 #include "stdincludes.h"
@@ -14,48 +21,113 @@
 /*
  * Macros
  */
-// number of writes after which to flush file
-#define MAXWRITES 1
 #define MAGIC_NUMBER "CS425"
 #define DBG_LOG "dbg.log"
 #define STATS_LOG "stats.log"
+// longest line LOG formats, longer ones are cut
+#define LOG_LINE_SIZE 30000
+// independently locked parts of the BINARY_LOG string table
+#define LOG_STRING_STRIPES 16
+// least severe logLEVEL compiled in, build with e.g.
+// make LOGFLAGS=-DLOG_COMPILE_LEVEL=LOG_LEVEL_INFO to drop the debug lines
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// whether a line of this level and category would be written. Levels below
+// LOG_COMPILE_LEVEL fold to false, and the call and its arguments go away.
+#define LOG_ENABLED(log, level, category) \
+    ((level) >= LOG_COMPILE_LEVEL && (log)->enabled(level, category))
+
+// LOG only when enabled, the arguments are not evaluated otherwise
+#define LOG_AT(log, level, category, address, ...) \
+    do {                                           \
+        if (LOG_ENABLED(log, level, category)) {   \
+            (log)->LOG(address, __VA_ARGS__);      \
+        }                                          \
+    } while (0)
+#define LOG_DEBUG(log, category, address, ...) \
+    LOG_AT(log, LOG_LEVEL_DEBUG, category, address, __VA_ARGS__)
+#define LOG_INFO(log, category, address, ...) \
+    LOG_AT(log, LOG_LEVEL_INFO, category, address, __VA_ARGS__)
+#define LOG_WARN(log, category, address, ...) \
+    LOG_AT(log, LOG_LEVEL_WARN, category, address, __VA_ARGS__)
+#define LOG_ERROR(log, category, address, ...) \
+    LOG_AT(log, LOG_LEVEL_ERROR, category, address, __VA_ARGS__)
+
+/**
+ * STRUCT NAME: StringStripe
+ *
+ * DESCRIPTION: Part of the BINARY_LOG string table, with its own lock
+ */
+typedef struct StringStripe {
+    mutex lock;
+    unordered_map<string, uint32_t> ids;
+} StringStripe;
 
 /**
  * CLASS NAME: Log
  *
  * DESCRIPTION: Functions to log messages in a debug log
+ * 				All state lives in the instance and lines are formatted
+ * in per-thread buffers, so any number of threads can log at once. Lines
+ * from different threads never interleave, and no lock is shared by all
+ * of them.
  */
 class Log {
    private:
     Params *par;
-    bool firstTime;
+    // the files are created by the first line logged
+    once_flag opened;
+    unique_ptr<LogWriter> dbgWriter;
+    unique_ptr<LogWriter> statsWriter;
+    unique_ptr<LogWriter> eventWriter;
+    // whether the first line, which goes out without an address, is taken
+    atomic<bool> firstTaken;
+    // BINARY_LOG: id of every key and value written to dbg.bin so far
+    StringStripe stringStripes[LOG_STRING_STRIPES];
+    atomic<uint32_t> nextString;
+
+    void open();
+    bool takeFirst();
+    uint32_t putString(const string &s, bool intern);
+    uint32_t defineString(const string &s);
+    void logEvent(Address *addr, EventType type, uint8_t flags, int transID,
+                  uint32_t key, uint32_t value);
+    void logKeyEvent(Address *addr, EventType type, bool isCoordinator,
+                     int transID, const string &key, const string *value);
+    void logNodeEvent(Address *thisNode, EventType type, Address *other);
 
    public:
     Log(Params *p);
-    Log(const Log &anotherLog);
-    Log &operator=(const Log &anotherLog);
+    Log(const Log &anotherLog) = delete;
+    Log &operator=(const Log &anotherLog) = delete;
     virtual ~Log();
+    // LOG writes unconditionally, the LOG_* macros filter first
     void LOG(Address *, const char *str, ...);
+    bool enabled(int level, int category) const {
+        return level >= par->LOG_LEVEL && (category & par->LOG_CATEGORIES);
+    }
     void logNodeAdd(Address *, Address *);
     void logNodeRemove(Address *, Address *);
     // success
     void logCreateSuccess(Address *address, bool isCoordinator, int transID,
-                          string key, string value);
+                          const string &key, const string &value);
     void logReadSuccess(Address *address, bool isCoordinator, int transID,
-                        string key, string value);
+                        const string &key, const string &value);
     void logUpdateSuccess(Address *address, bool isCoordinator, int transID,
-                          string key, string newValue);
+                          const string &key, const string &newValue);
     void logDeleteSuccess(Address *address, bool isCoordinator, int transID,
-                          string key);
+                          const string &key);
     // fail
     void logCreateFail(Address *address, bool isCoordinator, int transID,
-                       string key, string value);
+                       const string &key, const string &value);
     void logReadFail(Address *address, bool isCoordinator, int transID,
-                     string key);
+                     const string &key);
     void logUpdateFail(Address *address, bool isCoordinator, int transID,
-                       string key, string newValue);
+                       const string &key, const string &newValue);
     void logDeleteFail(Address *address, bool isCoordinator, int transID,
-                       string key);
+                       const string &key);
 };
 
 #endif /* _LOG_H_ */
@@ -0,0 +1,179 @@
+/**********************************
+ * FILE NAME: LogRender.cpp
+ *
+ * DESCRIPTION: Render the binary event log back to text
+ *
+ * RUN PROCEDURE:
+ * $ ./LogRender [-s] [dbg.bin] > dbg.log
+ *
+ * Prints what dbg.log would have held, or stats.log with -s, had the run
+ * logged text. The output is byte for byte what Log writes with BINARY_LOG
+ * off, so the graders can read it.
+ **********************************/
+
+#include "EventLog.h"
+#include "Log.h"
+#include "stdincludes.h"
+
+/**
+ * Text of the CRUD events, indexed from EVENT_CREATE_SUCCESS
+ */
+static const struct {
+    const char *op;
+    const char *outcome;
+    bool hasValue;
+} crudEvents[] = {
+    {"create", "success", true}, {"read", "success", true},
+    {"update", "success", true}, {"delete", "success", false},
+    {"create", "fail", true},    {"read", "fail", false},
+    {"update", "fail", true},    {"delete", "fail", false},
+};
+
+/**
+ * FUNCTION NAME: renderEvent
+ *
+ * DESCRIPTION: text Log would have passed to LOG for rec
+ */
+static string renderEvent(const EventRecord &rec,
+                          const vector<string> &strings) {
+    char buffer[200];
+    uint8_t addr[4];
+    int16_t port;
+
+    switch (rec.type) {
+        case EVENT_TEXT:
+            return strings.at(rec.value);
+
+        case EVENT_NODE_ADD:
+        case EVENT_NODE_REMOVE:
+            memcpy(addr, &rec.key, sizeof(addr));
+            port = (int16_t)rec.value;
+            sprintf(buffer, "Node %d.%d.%d.%d:%d %s at time %d", (char)addr[0],
+                    (char)addr[1], (char)addr[2], (char)addr[3], port,
+                    rec.type == EVENT_NODE_ADD ? "joined" : "removed",
+                    rec.time);
+            return buffer;
+
+        default:
+            break;
+    }
+
+    auto &e = crudEvents[rec.type - EVENT_CREATE_SUCCESS];
+    string text = rec.flags & EVENT_COORDINATOR ? "coordinator" : "server";
+    sprintf(buffer, ": %s %s at time %d, transID=%d, key=", e.op, e.outcome,
+            rec.time, rec.transID);
+    text += buffer + strings.at(rec.key);
+    if (e.hasValue) text += ", value=" + strings.at(rec.value);
+    return text;
+}
+
+/**
+ * FUNCTION NAME: stringsDefined
+ *
+ * DESCRIPTION: whether every string rec refers to was defined before it
+ */
+static bool stringsDefined(const EventRecord &rec,
+                           const vector<bool> &defined) {
+    auto known = [&](uint32_t id) {
+        return id < defined.size() && defined[id];
+    };
+
+    switch (rec.type) {
+        case EVENT_TEXT:
+            return known(rec.value);
+        case EVENT_NODE_ADD:
+        case EVENT_NODE_REMOVE:
+            return true;
+        default:
+            break;
+    }
+    return known(rec.key) &&
+           (!crudEvents[rec.type - EVENT_CREATE_SUCCESS].hasValue ||
+            known(rec.value));
+}
+
+int main(int argc, char *argv[]) {
+    bool stats = argc > 1 && 0 == strcmp(argv[1], "-s");
+    const char *path = argc > 1 + stats ? argv[1 + stats] : DBG_BIN;
+
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        cerr << "Unable to open event log " << path << endl;
+        return FAILURE;
+    }
+
+    EventLogHeader header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        memcmp(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != EVENT_LOG_VERSION ||
+        header.recordSize != sizeof(EventRecord)) {
+        cerr << path << " is not an event log of this version" << endl;
+        return FAILURE;
+    }
+
+    // bytes after the header, which bound the length and the id of a string
+    long start = ftell(fp);
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, start, SEEK_SET);
+
+    vector<string> strings;
+    vector<bool> defined;
+    EventRecord rec;
+    bool magicDone = stats;
+    while (fread(&rec, sizeof(rec), 1, fp) == 1) {
+        long remaining = size - ftell(fp);
+        if (rec.type == EVENT_STRING) {
+            // ids are handed out in order, but threads may write them a
+            // little out of it, so each later record can define at most one
+            if (rec.transID < 0 || rec.transID > remaining ||
+                rec.key > strings.size() + remaining / sizeof(rec)) {
+                cerr << path << " is a corrupt event log" << endl;
+                return FAILURE;
+            }
+            string s(rec.transID, '\0');
+            if (rec.transID > 0 && fread(&s[0], rec.transID, 1, fp) != 1) {
+                break;
+            }
+            if (strings.size() <= rec.key) {
+                strings.resize(rec.key + 1);
+                defined.resize(rec.key + 1, false);
+            }
+            strings[rec.key] = s;
+            defined[rec.key] = true;
+            continue;
+        }
+        if (rec.type >= DUMMYLASTEVENTTYPE) {
+            cerr << "Unknown event type " << (int)rec.type << endl;
+            return FAILURE;
+        }
+        if (!stringsDefined(rec, defined)) {
+            cerr << path << " is a corrupt event log" << endl;
+            return FAILURE;
+        }
+
+        // the magic number heads dbg.log once anything was logged
+        if (!magicDone) {
+            int magicNumber = 0;
+            for (const char *c = MAGIC_NUMBER; *c; c++) magicNumber += *c;
+            printf("%x\n", magicNumber);
+            magicDone = true;
+        }
+        if (stats != ((rec.flags & EVENT_STATS) != 0)) continue;
+
+        // the first line of a run goes out without the address of its node
+        char prefix[30] = "";
+        if (!(rec.flags & EVENT_FIRST)) {
+            int16_t port;
+            memcpy(&port, &rec.node[4], sizeof(port));
+            sprintf(prefix, "%d.%d.%d.%d:%d ", (char)rec.node[0],
+                    (char)rec.node[1], (char)rec.node[2], (char)rec.node[3],
+                    port);
+        }
+        printf("\n %s[%d] %s", prefix, rec.time,
+               renderEvent(rec, strings).c_str());
+    }
+
+    fclose(fp);
+    return SUCCESS;
+}
@@ -0,0 +1,136 @@
+/**********************************
+ * FILE NAME: LogWriter.cpp
+ *
+ * DESCRIPTION: LogWriter class definition
+ **********************************/
+
+#include "LogWriter.h"
+
+mutex LogWriter::openWritersLock;
+vector<LogWriter *> LogWriter::openWriters;
+
+/**
+ * Constructor, truncates the file at path and starts the writer thread
+ */
+LogWriter::LogWriter(const char *path)
+    : reserved(0), head(0), tail(0), stopping(false) {
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ring = (char *)malloc(LOG_RING_SIZE);
+    writer = thread(&LogWriter::run, this);
+
+    lock_guard<mutex> guard(openWritersLock);
+    static bool registered = false;
+    if (!registered) {
+        atexit(closeAll);
+        registered = true;
+    }
+    openWriters.push_back(this);
+}
+
+/**
+ * Destructor, writes out what is still buffered
+ */
+LogWriter::~LogWriter() {
+    close();
+    free(ring);
+}
+
+/**
+ * FUNCTION NAME: close
+ *
+ * DESCRIPTION: stop the writer thread and write out what is still buffered.
+ * Later appends are dropped.
+ */
+void LogWriter::close() {
+    if (stopping.exchange(true, memory_order_acq_rel)) return;
+
+    writer.join();
+    drain();
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+
+    lock_guard<mutex> guard(openWritersLock);
+    openWriters.erase(find(openWriters.begin(), openWriters.end(), this));
+}
+
+/**
+ * FUNCTION NAME: closeAll
+ *
+ * DESCRIPTION: close the writers still open, run at exit
+ */
+void LogWriter::closeAll() {
+    vector<LogWriter *> writers;
+    {
+        lock_guard<mutex> guard(openWritersLock);
+        writers = openWriters;
+    }
+    for (auto *w : writers) {
+        w->close();
+    }
+}
+
+/**
+ * FUNCTION NAME: append
+ *
+ * DESCRIPTION: queue len bytes for the file, at most LOG_RING_SIZE. Safe to
+ * call from any number of threads, waits for the writer when the ring is
+ * full.
+ */
+void LogWriter::append(const char *data, size_t len) {
+    assert(len <= LOG_RING_SIZE);
+    if (len == 0 || stopping.load(memory_order_acquire)) return;
+
+    size_t start = reserved.fetch_add(len, memory_order_relaxed);
+    while (start + len - tail.load(memory_order_acquire) > LOG_RING_SIZE) {
+        this_thread::yield();
+    }
+
+    size_t off = start & (LOG_RING_SIZE - 1);
+    size_t n = min(len, (size_t)LOG_RING_SIZE - off);
+    memcpy(ring + off, data, n);
+    memcpy(ring, data + n, len - n);
+
+    // publish in reservation order, the writer only sees whole lines
+    while (head.load(memory_order_acquire) != start) {
+        this_thread::yield();
+    }
+    head.store(start + len, memory_order_release);
+}
+
+/**
+ * FUNCTION NAME: drain
+ *
+ * DESCRIPTION: write everything published so far
+ *
+ * RETURNS:
+ * number of bytes taken off the ring
+ */
+size_t LogWriter::drain() {
+    size_t t = tail.load(memory_order_relaxed);
+    size_t h = head.load(memory_order_acquire);
+    size_t total = h - t;
+
+    while (t < h) {
+        size_t off = t & (LOG_RING_SIZE - 1);
+        size_t n = min(h - t, (size_t)LOG_RING_SIZE - off);
+        ssize_t written = fd >= 0 ? write(fd, ring + off, n) : (ssize_t)n;
+        // a failing disk loses the log rather than stalling the run
+        if (written <= 0) written = n;
+        t += written;
+        tail.store(t, memory_order_release);
+    }
+    return total;
+}
+
+/**
+ * FUNCTION NAME: run
+ *
+ * DESCRIPTION: body of the writer thread
+ */
+void LogWriter::run() {
+    while (!stopping.load(memory_order_acquire)) {
+        if (drain() == 0) {
+            this_thread::sleep_for(chrono::microseconds(LOG_WRITER_IDLE_US));
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/**********************************
+ * FILE NAME: LogWriter.h
+ *
+ * DESCRIPTION: Header file of LogWriter class
+ **********************************/
+
+#ifndef _LOGWRITER_H_
+#define _LOGWRITER_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "stdincludes.h"
+
+/*
+ * Macros
+ */
+// bytes buffered per log file, a power of two
+#define LOG_RING_SIZE (1 << 20)
+// microseconds the writer sleeps when there is nothing to write
+#define LOG_WRITER_IDLE_US 1000
+
+/**
+ * CLASS NAME: LogWriter
+ *
+ * DESCRIPTION: Appends to one log file from a background thread
+ * 				Any number of threads copy lines into a ring buffer
+ * without taking a lock: each reserves its bytes with one atomic add, and
+ * publishes them once every earlier reservation is published, so lines
+ * never interleave. The writer thread drains whatever has accumulated with
+ * one write() per contiguous run of the ring. Writers still open when the
+ * process exits are drained then, so the file is complete even after an
+ * exit() that skips the destructors.
+ */
+class LogWriter {
+   private:
+    int fd;
+    char *ring;
+    // bytes ever reserved, published and written, the ring holds the
+    // published bytes not yet written
+    atomic<size_t> reserved;
+    atomic<size_t> head;
+    atomic<size_t> tail;
+    atomic<bool> stopping;
+    thread writer;
+
+    // writers to close at exit
+    static mutex openWritersLock;
+    static vector<LogWriter *> openWriters;
+    static void closeAll();
+
+    void run();
+    size_t drain();
+
+   public:
+    LogWriter(const char *path);
+    LogWriter(const LogWriter &) = delete;
+    LogWriter &operator=(const LogWriter &) = delete;
+    virtual ~LogWriter();
+    void append(const char *data, size_t len);
+    void close();
+};
+
+#endif /* _LOGWRITER_H_ */
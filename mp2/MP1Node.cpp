@@ -7,7 +7,6 @@
 
 #include "MP1Node.h"
 
-#include <random>
 #include <unordered_map>
 
 /*
@@ -22,11 +21,23 @@
 MP1Node::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log,
                  Address *address) {
     memset(NULLADDR, 0, ADDR_LEN * sizeof(char));
+    this->memberVersion = 0;
+    this->probeTarget = 0;
+    this->probeStart = 0;
+    this->probeInProgress = false;
+    this->probeAcked = false;
+    this->pingReqSent = false;
+    this->probeIndex = 0;
+    this->localHealth = 0;
+    this->queueSince = -1;
+    this->relayTime = -1;
+    this->relayBudget = 0;
     this->memberNode = member;
     this->emulNet = emul;
     this->log = log;
     this->par = params;
     this->memberNode->addr = *address;
+    this->rng.seed(par->SEED, GOSSIP_STREAM, getIdFromAddr(address->addr));
 }
 
 /**
@@ -45,8 +56,12 @@ int MP1Node::recvLoop() {
     if (memberNode->bFailed) {
         return false;
     } else {
-        return emulNet->ENrecv(&(memberNode->addr), enqueueWrapper, NULL, 1,
-                               &(memberNode->mp1q));
+        int ret = emulNet->ENrecv(&(memberNode->addr), enqueueWrapper, NULL,
+                                  1, &(memberNode->mp1q));
+        if (queueSince < 0 && !memberNode->mp1q.empty()) {
+            queueSince = par->getcurrtime();
+        }
+        return ret;
     }
 }
 
@@ -60,6 +75,25 @@ int MP1Node::enqueueWrapper(void *env, char *buff, int size) {
     return q.enqueue((queue<q_elt> *)env, (void *)buff, size);
 }
 
+static const char *msgTypeNames[DUMMYLASTMSGTYPE + 1] = {
+    "JOINREQ", "JOINREP", "GOSSIP", "SYNCREQ", "JOINANN", "DIGEST",
+    "DIGESTREP", "PING", "PINGREQ", "ACK", "OTHER"};
+
+const TrafficClass MP1Node::trafficClass = {
+    "mp1", DUMMYLASTMSGTYPE + 1, msgTypeNames, msgTypeOf, EMULNET_STREAM};
+
+/**
+ * FUNCTION NAME: msgTypeOf
+ *
+ * DESCRIPTION: MsgTypes of a message sent on the membership EmulNet
+ */
+int MP1Node::msgTypeOf(const char *data, int size) {
+    MsgTypes type;
+    if (size < (int)sizeof(type)) return DUMMYLASTMSGTYPE;
+    memcpy(&type, data, sizeof(type));
+    return type;
+}
+
 /**
  * FUNCTION NAME: nodeStart
  *
@@ -71,19 +105,24 @@ void MP1Node::nodeStart(char *servaddrstr, short servport) {
     Address joinaddr;
     joinaddr = getJoinAddress();
 
+    if (frameBudget() == 0) {
+        LOG_ERROR(log, LOG_MEMBERSHIP, &memberNode->addr,
+                  "MAX_MSG_SIZE %d leaves no room for a member entry. Exit.",
+                  par->MAX_MSG_SIZE);
+        exit(1);
+    }
+
     // Self booting routines
     if (initThisNode(&joinaddr) == -1) {
-#ifdef DEBUGLOG
-        log->LOG(&memberNode->addr, "init_thisnode failed. Exit.");
-#endif
+        LOG_ERROR(log, LOG_MEMBERSHIP, &memberNode->addr,
+                  "init_thisnode failed. Exit.");
         exit(1);
     }
 
     if (!introduceSelfToGroup(&joinaddr)) {
         finishUpThisNode();
-#ifdef DEBUGLOG
-        log->LOG(&memberNode->addr, "Unable to join self to group. Exiting.");
-#endif
+        LOG_ERROR(log, LOG_MEMBERSHIP, &memberNode->addr,
+                  "Unable to join self to group. Exiting.");
         exit(1);
     }
 
@@ -121,27 +160,20 @@ int MP1Node::initThisNode(Address *joinaddr) {
  * DESCRIPTION: Join the distributed system
  */
 int MP1Node::introduceSelfToGroup(Address *joinaddr) {
-#ifdef DEBUGLOG
-    static char s[1024];
-#endif
-
     if (0 == memcmp((char *)&(memberNode->addr.addr), (char *)&(joinaddr->addr),
                     sizeof(memberNode->addr.addr))) {
         // I am the group booter (first process to join the group). Boot up the
         // group
-#ifdef DEBUGLOG
-        log->LOG(&memberNode->addr, "Starting up group...");
-#endif
+        LOG_DEBUG(log, LOG_MEMBERSHIP, &memberNode->addr,
+                  "Starting up group...");
         memberNode->inGroup = true;
     } else {
-#ifdef DEBUGLOG
-        sprintf(s, "Trying to join...");
-        log->LOG(&memberNode->addr, s);
-#endif
+        LOG_DEBUG(log, LOG_MEMBERSHIP, &memberNode->addr, "Trying to join...");
 
         // create JOINREQ message: format of data is {struct Address myaddr}
         // send JOINREQ message to introducer member
-        sendMsg(joinaddr, JOINREQ);
+        auto introducer = getIntroducerAddress();
+        sendMsg(&introducer, JOINREQ);
     }
 
     return 1;
@@ -182,7 +214,9 @@ void MP1Node::nodeLoop() {
     }
 
     // ...then jump in and share your responsibilites!
+    announceJoins();
     nodeLoopOps();
+    antiEntropy();
 
     return;
 }
@@ -197,6 +231,11 @@ void MP1Node::checkMessages() {
     void *ptr;
     int size;
 
+    // a slow node only gets to its queue now and then
+    if (isSlowNode() && par->getcurrtime() % par->SLOW_NODE_DELAY != 0) {
+        return;
+    }
+
     // Pop waiting messages from memberNode's mp1q
     while (!memberNode->mp1q.empty()) {
         ptr = memberNode->mp1q.front().elt;
@@ -204,9 +243,49 @@ void MP1Node::checkMessages() {
         memberNode->mp1q.pop();
         recvCallBack((void *)memberNode, (char *)ptr, size);
     }
+
+    // messages that waited in the queue mean this node is falling behind
+    if (queueSince >= 0) {
+        adjustLocalHealth(par->getcurrtime() > queueSince ? 1 : -1);
+        queueSince = -1;
+    }
     return;
 }
 
+/**
+ * FUNCTION NAME: isSlowNode
+ *
+ * DESCRIPTION: whether this node is one of the last SLOW_NODES nodes, which
+ * read their messages only every SLOW_NODE_DELAY time units
+ */
+bool MP1Node::isSlowNode() {
+    int id = getIdFromAddr(memberNode->addr.addr);
+    return par->SLOW_NODE_DELAY > 1 && id > par->EN_GPSZ - par->SLOW_NODES;
+}
+
+/**
+ * FUNCTION NAME: adjustLocalHealth
+ *
+ * DESCRIPTION: move the local health multiplier, within [0, LHM_MAX]
+ * 				As in Lifeguard, a node that misses acks for its own
+ * probes, has to refute suspicions about itself or finds messages waiting
+ * in its queue is more likely slow itself than surrounded by failures. It
+ * then stretches its own timeouts and probes less often, rather than
+ * accusing healthy members and churning the ring of MP2.
+ */
+void MP1Node::adjustLocalHealth(int delta) {
+    localHealth = max(0, min(LHM_MAX, localHealth + delta));
+}
+
+/**
+ * FUNCTION NAME: healthScaled
+ *
+ * DESCRIPTION: a timeout stretched by the local health multiplier
+ */
+long MP1Node::healthScaled(long timeout) {
+    return timeout * (localHealth + 1);
+}
+
 /**
  * FUNCTION NAME: recvCallBack
  *
@@ -232,6 +311,28 @@ bool MP1Node::recvCallBack(void *env, char *data, int size) {
             handleRecvGossipMsg(m, msg, size);
             break;
 
+        case SYNCREQ:
+            handleRecvSyncReq(m, msg, size);
+            break;
+
+        case JOINANN:
+            handleRecvJoinAnn(m, msg, size);
+            break;
+
+        case DIGEST:
+            handleRecvDigest(m, msg, size);
+            break;
+
+        case DIGESTREP:
+            handleRecvDigestRep(m, msg, size);
+            break;
+
+        case PING:
+        case PINGREQ:
+        case ACK:
+            handleRecvSwimMsg(m, msg, size);
+            break;
+
         default:
             return false;
     }
@@ -250,39 +351,51 @@ void MP1Node::nodeLoopOps() {
     /*
      * Your code goes here
      */
+    if (par->MEMBERSHIP_PROTOCOL == SWIM_PROTOCOL) {
+        swimLoopOps();
+        return;
+    }
 
     // Update heartbeat
     memberNode->heartbeat++;
 
-    // remove member if necessary
+    // a member whose heartbeat is overdue becomes suspect, and is removed if
+    // it stays silent for the suspicion timeout. Any newer
+    // heartbeat clears the suspicion, so the heartbeat plays the part of the
+    // incarnation number here.
     auto curTime = par->getcurrtime();
     auto myId = getIdFromAddr(memberNode->addr.addr);
+    long timeout = suspicionTimeout(TFAIL);
 
-    auto prevMemberList = memberNode->memberList;
-    memberNode->memberList.clear();
-    for (auto &m : prevMemberList) {
+    auto &memberList = memberNode->memberList;
+    for (size_t i = 0; i < memberList.size();) {
+        auto &m = memberList[i];
         if (myId == m.getid()) {
             m.setheartbeat(memberNode->heartbeat);
             m.settimestamp(curTime);
-            memberNode->memberList.push_back(m);
-        } else if (curTime - m.getheartbeat() > 2 * TREMOVE) {
-            auto id = m.getid();
-            auto port = m.getport();
+            touchMember(&m);
+        } else if (suspectSince[i] < 0) {
+            if (heartbeatOverdue(i, curTime)) suspectSince[i] = curTime;
+        } else if (curTime - suspectSince[i] > timeout) {
             auto addr = Address();
-            memset(&addr, 0, sizeof(Address));
-            loadAddr(&addr, id, port);
+            addr.init();
+            loadAddr(&addr, m.getid(), m.getport());
             log->logNodeRemove(&memberNode->addr, &addr);
-        } else {
-            memberNode->memberList.push_back(m);
+            deadMembers[getMemberKey(m.getid(), m.getport())] =
+                DeadMember{m.getheartbeat(), curTime};
+            // the last entry moves into slot i, so look at i again
+            removeMember(i);
+            continue;
         }
+        ++i;
     }
+    expireDeadMembers(curTime, TFAIL);
 
-    // Gossiping
-    unordered_map<string, bool> exclude(
-        {{getIdAndPortString(getIdFromAddr(memberNode->addr.addr),
-                             getPortFromAddr(memberNode->addr.addr)),
-          true}});
-    gossip(exclude, par->getcurrtime());
+    // Gossiping, a new round started by this node
+    unordered_set<uint64_t> exclude{
+        getMemberKey(getIdFromAddr(memberNode->addr.addr),
+                     getPortFromAddr(memberNode->addr.addr))};
+    gossip(exclude, memberNode->addr.addr, curTime, gossipFanout());
 
     return;
 }
@@ -298,27 +411,32 @@ void MP1Node::updateMemberList(Member *m, char *addr, int heartbeat,
     auto port = getPortFromAddr(addr);
     auto curTime = par->getcurrtime();
 
-    for (auto &me : m->memberList) {
-        if (me.getid() == id && me.getport() == port) {
-            if (heartbeat <= me.heartbeat) return;
+    auto *me = findMember(id, port);
+    if (me) {
+        if (heartbeat <= me->heartbeat) return;
 
-            // update member
-            me.setheartbeat(heartbeat);
-            me.settimestamp(curTime);
+        // update member
+        me->setheartbeat(heartbeat);
+        me->settimestamp(curTime);
+        suspectSince[me - memberNode->memberList.data()] = -1;
+        detectors[me - memberNode->memberList.data()].heartbeat(curTime);
+        touchMember(me);
 
-            return;
-        }
+        return;
     }
 
-    // insert new member
+    // insert new member, unless it is stale news about a removed one
+    auto dead = deadMembers.find(getMemberKey(id, port));
+    if (dead != deadMembers.end() && heartbeat <= dead->second.heartbeat)
+        return;
     if (m->heartbeat - TREMOVE < heartbeat) {
-        MemberListEntry me(id, port, heartbeat, curTime);
-        m->memberList.push_back(me);
+        if (dead != deadMembers.end()) deadMembers.erase(dead);
+        addMember(MemberListEntry(id, port, heartbeat, curTime));
 
         // construct an Address instance
         if (getIdFromAddr(m->addr.addr) != id) {
             auto a = Address();
-            memset(&a, 0, sizeof(Address));
+            a.init();
             memcpy(a.addr, addr, ADDR_LEN);
             log->logNodeAdd(&m->addr, &a);
         }
@@ -327,6 +445,139 @@ void MP1Node::updateMemberList(Member *m, char *addr, int heartbeat,
     return;
 }
 
+/**
+ * FUNCTION NAME: findMember
+ *
+ * DESCRIPTION: look up a member through memberIndex, NULL if not present
+ */
+MemberListEntry *MP1Node::findMember(int id, short port) {
+    auto it = memberIndex.find(getMemberKey(id, port));
+    if (it == memberIndex.end()) return NULL;
+
+    return &memberNode->memberList[it->second];
+}
+
+/**
+ * FUNCTION NAME: addMember
+ *
+ * DESCRIPTION: append a member and index it
+ */
+void MP1Node::addMember(const MemberListEntry &e) {
+    memberIndex[getMemberKey(e.id, e.port)] = memberNode->memberList.size();
+    memberNode->memberList.push_back(e);
+    memberVersions.push_back(++memberVersion);
+    suspectSince.push_back(-1);
+    detectors.push_back(PhiAccrual());
+    detectors.back().heartbeat(par->getcurrtime());
+}
+
+/**
+ * FUNCTION NAME: removeMember
+ *
+ * DESCRIPTION: remove the member in slot by moving the last entry into it
+ */
+void MP1Node::removeMember(size_t slot) {
+    auto &memberList = memberNode->memberList;
+    auto &removed = memberList[slot];
+    memberIndex.erase(getMemberKey(removed.getid(), removed.getport()));
+    // a member that comes back starts with a full sync
+    gossipPeers.erase(getMemberKey(removed.getid(), removed.getport()));
+
+    if (slot != memberList.size() - 1) {
+        memberList[slot] = memberList.back();
+        auto &moved = memberList[slot];
+        memberIndex[getMemberKey(moved.getid(), moved.getport())] = slot;
+        memberVersions[slot] = memberVersions.back();
+        suspectSince[slot] = suspectSince.back();
+        detectors[slot] = detectors.back();
+    }
+    memberList.pop_back();
+    memberVersions.pop_back();
+    suspectSince.pop_back();
+    detectors.pop_back();
+}
+
+/**
+ * FUNCTION NAME: touchMember
+ *
+ * DESCRIPTION: mark a member as changed so the next delta gossip carries it
+ */
+void MP1Node::touchMember(MemberListEntry *me) {
+    memberVersions[me - memberNode->memberList.data()] = ++memberVersion;
+}
+
+/**
+ * FUNCTION NAME: suspicionTimeout
+ *
+ * DESCRIPTION: time a member stays suspect before it is removed
+ * 				Scaled by log10 of the group size, as news of a
+ * refutation takes O(log n) periods to spread.
+ */
+long MP1Node::suspicionTimeout(long period) {
+    double n = max((size_t)1, memberNode->memberList.size());
+    return healthScaled(
+        (long)ceil(par->SUSPICION_MULT * max(1.0, log10(n)) * period));
+}
+
+/**
+ * FUNCTION NAME: expireDeadMembers
+ *
+ * DESCRIPTION: drops tombstones older than twice TREMOVE periods
+ * 				By then every other member has removed the dead one
+ * as well and nobody spreads its old heartbeat any more, so keeping the
+ * tombstone would only slow down lookups. A single TREMOVE was too short
+ * under SWIM, where late DEAD updates came back and were spread again. The
+ * grace is also at least twice the suspicion timeout, as peers that
+ * suspected the member later remove it later. Sweeps once every TREMOVE
+ * time units.
+ */
+void MP1Node::expireDeadMembers(long curTime, long period) {
+    if (curTime % TREMOVE != 0) return;
+    long grace =
+        max((long)2 * TREMOVE * period, 2 * suspicionTimeout(period));
+    for (auto it = deadMembers.begin(); it != deadMembers.end();) {
+        if (curTime - it->second.removedAt > grace) {
+            it = deadMembers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * FUNCTION NAME: heartbeatOverdue
+ *
+ * DESCRIPTION: whether the heartbeat of the member in slot is late enough to
+ * suspect it
+ * 				Uses the phi accrual level once the member has a few
+ * heartbeats of history, so the timeout follows the observed arrival
+ * pattern: tight on a clean network, looser when messages are dropped.
+ * Falls back to TFAIL before that, or when PHI_THRESHOLD is 0. Both are
+ * stretched while this node is unhealthy itself.
+ */
+bool MP1Node::heartbeatOverdue(size_t slot, long curTime) {
+    if (par->PHI_THRESHOLD > 0 && detectors[slot].ready()) {
+        return detectors[slot].phi(curTime) >
+               par->PHI_THRESHOLD * (localHealth + 1);
+    }
+    return curTime - memberNode->memberList[slot].gettimestamp() >
+           healthScaled(TFAIL);
+}
+
+/**
+ * FUNCTION NAME: suspicionLevel
+ *
+ * DESCRIPTION: phi accrual suspicion level of a member, 0 for unknown
+ * members and members without enough heartbeat history
+ */
+double MP1Node::suspicionLevel(int id, short port) {
+    auto *me = findMember(id, port);
+    if (me == NULL) return 0;
+
+    return detectors[me - memberNode->memberList.data()].phi(
+        par->getcurrtime());
+}
+
 /**
  * FUNCTION NAME: handleRecvJoinRep
  *
@@ -335,7 +586,23 @@ void MP1Node::updateMemberList(Member *m, char *addr, int heartbeat,
 void MP1Node::handleRecvJoinRep(Member *m, MessageHdr *msg, int msgSize) {
     // node has joined the group
     m->inGroup = true;
-    return updateMemberList(m, msg->addr, m->heartbeat, par->getcurrtime());
+
+    // the reply carries the membership list of the introducer, split into
+    // frames like any gossip when it is large
+    vector<MemberListEntry> snapshot;
+    vector<MemberListEntry> sent;
+    char *data = (char *)msg + sizeof(MessageHdr);
+    unmarshall(data, msg->dataSize, msg->sentSize, snapshot, sent);
+    applyJoinedMembers(m, snapshot);
+
+    if (msg->fragment > 0) return;
+
+    if (par->MEMBERSHIP_PROTOCOL == SWIM_PROTOCOL) {
+        applySwimUpdate(getIdFromAddr(msg->addr), getPortFromAddr(msg->addr),
+                        0, MEMBER_ALIVE, false);
+    } else {
+        updateMemberList(m, msg->addr, m->heartbeat, par->getcurrtime());
+    }
 }
 
 /**
@@ -344,11 +611,144 @@ void MP1Node::handleRecvJoinRep(Member *m, MessageHdr *msg, int msgSize) {
  * DESCRIPTION: handle function for Receiving Join Request
  */
 void MP1Node::handleRecvJoinReq(Member *m, MessageHdr *msg, int msgSize) {
+    // an introducer that has not joined yet itself hands the request on to
+    // the group booter
+    if (!m->inGroup) {
+        auto booter = getJoinAddress();
+        emulNet->ENsend(&memberNode->addr, &booter, (char *)msg, msgSize);
+        return;
+    }
+
+    int id = getIdFromAddr(msg->addr);
+    short port = getPortFromAddr(msg->addr);
+    if (par->MEMBERSHIP_PROTOCOL == SWIM_PROTOCOL) {
+        // let the group know through piggybacking
+        applySwimUpdate(id, port, 0, MEMBER_ALIVE, true);
+    } else {
+        updateMemberList(m, msg->addr, m->heartbeat, par->getcurrtime());
+    }
+
+    // the newcomer is announced to the group at the next announceJoins, and
+    // unless it is an introducer itself, it is one of ours to tell from now
+    if (par->JOIN_ANNOUNCE_FANOUT > 0) {
+        auto *me = findMember(id, port);
+        if (me) newJoins.push_back(*me);
+        if (!isIntroducer(id)) introduced.push_back(getMemberKey(id, port));
+    }
+
+    // reply with everything this node knows, newcomer included, so it does
+    // not have to learn the group one gossip at a time
     auto a = Address();
-    memset(&a, 0, sizeof(Address));
+    a.init();
     memcpy(a.addr, msg->addr, ADDR_LEN);
-    sendMsg(&a, JOINREP);
-    return updateMemberList(m, msg->addr, m->heartbeat, par->getcurrtime());
+    auto peer =
+        getMemberKey(getIdFromAddr(msg->addr), getPortFromAddr(msg->addr));
+    gossipPeers.erase(peer);
+
+    vector<MemberListEntry> snapshot;
+    vector<MemberListEntry> sent;
+    collectGossipEntries(peer, snapshot);
+    sendMsg(&a, JOINREP, snapshot, sent, par->getcurrtime());
+}
+
+/**
+ * FUNCTION NAME: handleRecvJoinAnn
+ *
+ * DESCRIPTION: handle function for Receiving Join Announcement
+ * 				An introducer also passes the joins announced by the
+ * other introducers on to the nodes it introduced.
+ */
+void MP1Node::handleRecvJoinAnn(Member *m, MessageHdr *msg, int msgSize) {
+    vector<MemberListEntry> joined;
+    vector<MemberListEntry> sent;
+    char *data = (char *)msg + sizeof(MessageHdr);
+    unmarshall(data, msg->dataSize, msg->sentSize, joined, sent);
+    applyJoinedMembers(m, joined);
+
+    if (isIntroducer(getIdFromAddr(m->addr.addr)) &&
+        isIntroducer(getIdFromAddr(msg->addr))) {
+        relayedJoins.insert(relayedJoins.end(), joined.begin(), joined.end());
+    }
+}
+
+/**
+ * FUNCTION NAME: applyJoinedMembers
+ *
+ * DESCRIPTION: add the members of a JOINREP snapshot or a JOINANN
+ */
+void MP1Node::applyJoinedMembers(Member *m, vector<MemberListEntry> &joined) {
+    for (auto &e : joined) {
+        if (par->MEMBERSHIP_PROTOCOL == SWIM_PROTOCOL) {
+            applySwimUpdate(e.id, e.port, e.heartbeat, MEMBER_ALIVE, false);
+        } else {
+            Address addr = Address();
+            addr.init();
+            loadAddr(&addr, e.id, e.port);
+            updateMemberList(m, addr.addr, e.heartbeat, e.timestamp);
+        }
+    }
+}
+
+/**
+ * FUNCTION NAME: announceJoins
+ *
+ * DESCRIPTION: tell the group about the nodes that joined since last time
+ * 				Joins form a two level tree: every introducer sends its
+ * new joins to the other introducers, and each introducer sends all of them
+ * to JOIN_ANNOUNCE_FANOUT random nodes it introduced, which gossip or
+ * piggyback them on. An introducer sends at most INTRODUCERS - 1 +
+ * JOIN_ANNOUNCE_FANOUT announcements per time unit, however many nodes it
+ * introduced, and nothing once nodes stop joining.
+ */
+void MP1Node::announceJoins() {
+    if (newJoins.empty() && relayedJoins.empty()) return;
+
+    auto curTime = par->getcurrtime();
+    int myId = getIdFromAddr(memberNode->addr.addr);
+    vector<MemberListEntry> none;
+    auto addr = Address();
+    addr.init();
+
+    for (int id = 1; !newJoins.empty() && isIntroducer(id); ++id) {
+        if (id == myId) continue;
+        loadAddr(&addr, id, 0);
+        sendMsg(&addr, JOINANN, newJoins, none, curTime);
+    }
+
+    // a partial Fisher-Yates shuffle draws the receivers
+    vector<MemberListEntry> joined(newJoins);
+    joined.insert(joined.end(), relayedJoins.begin(), relayedJoins.end());
+    int told = 0;
+    for (size_t i = 0;
+         i < introduced.size() && told < par->JOIN_ANNOUNCE_FANOUT;) {
+        swap(introduced[i],
+             introduced[i + rng.nextInt(introduced.size() - i)]);
+        int id;
+        short port;
+        loadIdAndPortFromKey(introduced[i], id, port);
+        // forget the ones that have since been removed
+        if (findMember(id, port) == NULL) {
+            introduced[i] = introduced.back();
+            introduced.pop_back();
+            continue;
+        }
+        loadAddr(&addr, id, port);
+        sendMsg(&addr, JOINANN, joined, none, curTime);
+        ++told;
+        ++i;
+    }
+
+    newJoins.clear();
+    relayedJoins.clear();
+}
+
+/**
+ * FUNCTION NAME: isIntroducer
+ *
+ * DESCRIPTION: whether node id answers join requests, see INTRODUCERS
+ */
+bool MP1Node::isIntroducer(int id) {
+    return id >= 1 && id <= max(1, par->INTRODUCERS);
 }
 
 /**
@@ -362,12 +762,26 @@ void MP1Node::handleRecvGossipMsg(Member *m, MessageHdr *msg, int msgSize) {
     char *data = (char *)msg + sizeof(MessageHdr);
     unmarshall(data, msg->dataSize, msg->sentSize, mle, sent);
 
+    // SWIM only uses GOSSIP to answer SYNCREQ, heartbeats are incarnations
+    if (par->MEMBERSHIP_PROTOCOL == SWIM_PROTOCOL) {
+        for (auto &e : mle) {
+            applySwimUpdate(e.id, e.port, e.heartbeat, MEMBER_ALIVE, false);
+        }
+        return;
+    }
+
+    // a sender we did not know about may have sent only a delta, ask it for
+    // everything it knows
+    bool unknownSender =
+        findMember(getIdFromAddr(msg->addr), getPortFromAddr(msg->addr)) ==
+        NULL;
+
     for (auto &e : mle) {
         auto id = e.getid();
         auto port = e.getport();
 
         Address addr = Address();
-        memset(&addr, 0, sizeof(Address));
+        addr.init();
         loadAddr(&addr, e.getid(), e.getport());
         updateMemberList(m, addr.addr, e.heartbeat, e.timestamp);
     }
@@ -375,69 +789,792 @@ void MP1Node::handleRecvGossipMsg(Member *m, MessageHdr *msg, int msgSize) {
     // update
     updateMemberList(m, msg->addr, m->heartbeat, msg->timestamp);
 
+    // the rest of a split gossip only carries entries, the first frame
+    // already triggered the sync request and the next round
+    if (msg->fragment > 0) return;
+
+    if (unknownSender) {
+        auto a = Address();
+        a.init();
+        memcpy(a.addr, msg->addr, ADDR_LEN);
+        sendMsg(&a, SYNCREQ);
+    }
+
     // Gossiping
+    // each round is forwarded at most once, and all forwarding together is
+    // held to one fanout worth of messages per time unit, however many
+    // rounds come in
+    char *origin = memcmp(msg->target, NULLADDR, ADDR_LEN) ? msg->target
+                                                            : msg->addr;
+    long curTime = par->getcurrtime();
+    if (relayTime != curTime) {
+        relayTime = curTime;
+        relayBudget = gossipFanout();
+    }
+    if (relayBudget <= 0 || !takeRound(origin, msg->timestamp)) return;
+
     // self and sender
-    unordered_map<string, bool> exclude(
-        {{getIdAndPortString(getIdFromAddr(memberNode->addr.addr),
-                             getPortFromAddr(memberNode->addr.addr)),
-          true},
-         {getIdAndPortString(getIdFromAddr(msg->addr),
-                             getPortFromAddr(msg->addr)),
-          true}});
+    unordered_set<uint64_t> exclude{
+        getMemberKey(getIdFromAddr(memberNode->addr.addr),
+                     getPortFromAddr(memberNode->addr.addr)),
+        getMemberKey(getIdFromAddr(msg->addr), getPortFromAddr(msg->addr))};
 
-    for (auto s : sent) {
-        exclude[getIdAndPortString(s.getid(), s.getport())] = true;
+    for (auto &s : sent) {
+        exclude.insert(getMemberKey(s.getid(), s.getport()));
     }
 
-    gossip(exclude, msg->timestamp);
+    relayBudget -= gossip(exclude, origin, msg->timestamp, relayBudget);
 
     return;
 }
 
+/**
+ * FUNCTION NAME: handleRecvSyncReq
+ *
+ * DESCRIPTION: handle function for Receiving Sync Request, reply with the
+ * whole membership list
+ */
+void MP1Node::handleRecvSyncReq(Member *m, MessageHdr *msg, int msgSize) {
+    auto a = Address();
+    a.init();
+    memcpy(a.addr, msg->addr, ADDR_LEN);
+
+    auto peer =
+        getMemberKey(getIdFromAddr(msg->addr), getPortFromAddr(msg->addr));
+    gossipPeers.erase(peer);
+
+    vector<MemberListEntry> entries;
+    collectGossipEntries(peer, entries);
+
+    vector<MemberListEntry> sent{
+        MemberListEntry(getIdFromAddr(m->addr.addr),
+                        getPortFromAddr(m->addr.addr)),
+        MemberListEntry(getIdFromAddr(msg->addr), getPortFromAddr(msg->addr))};
+    sendMsg(&a, GOSSIP, entries, sent, par->getcurrtime());
+}
+
+/**
+ * FUNCTION NAME: antiEntropy
+ *
+ * DESCRIPTION: start a push-pull exchange with a random member every
+ * ANTI_ENTROPY_INTERVAL
+ * 				The DIGEST holds one hash per bucket of the member list.
+ * The peer answers with a DIGESTREP holding its hashes and entries for the
+ * buckets that differ, and this node sends back the entries of those
+ * buckets the peer is missing or behind on. Buckets that agree only cost a
+ * hash, so updates lost to drops or a partition are repaired within an
+ * interval without pushing whole lists around.
+ */
+void MP1Node::antiEntropy() {
+    auto &memberList = memberNode->memberList;
+    int interval = par->ANTI_ENTROPY_INTERVAL;
+    if (interval <= 0 || memberList.size() < 2) return;
+
+    // staggered by id, so the group's exchanges spread over the interval
+    int myId = getIdFromAddr(memberNode->addr.addr);
+    short myPort = getPortFromAddr(memberNode->addr.addr);
+    if ((par->getcurrtime() + myId) % interval != 0) return;
+
+    MemberListEntry *peer;
+    do {
+        peer = &memberList[rng.nextInt(memberList.size())];
+    } while (peer->id == myId && peer->port == myPort);
+
+    size_t buckets = (memberList.size() + DIGEST_BUCKET_SIZE - 1) /
+                     DIGEST_BUCKET_SIZE;
+    buckets = min(buckets, (size_t)DIGEST_MAX_BUCKETS);
+    vector<uint32_t> hashes;
+    computeDigest(buckets, hashes);
+
+    // a bucket travels as the entry (index, bucket count, hash)
+    vector<MemberListEntry> digest;
+    for (size_t b = 0; b < buckets; ++b) {
+        digest.push_back(MemberListEntry(b, buckets, hashes[b], 0));
+    }
+    vector<MemberListEntry> none;
+    auto addr = Address();
+    addr.init();
+    loadAddr(&addr, peer->id, peer->port);
+    sendMsg(&addr, DIGEST, digest, none, par->getcurrtime());
+}
+
+/**
+ * FUNCTION NAME: computeDigest
+ *
+ * DESCRIPTION: hash of every bucket of the member list
+ * 				Members go to buckets by a hash of their key, and a
+ * bucket's hash is the sum of its members' (key, heartbeat) hashes, so it
+ * does not depend on the order of the list.
+ */
+void MP1Node::computeDigest(size_t buckets, vector<uint32_t> &hashes) {
+    hashes.assign(buckets, 0);
+    for (auto &me : memberNode->memberList) {
+        auto key = getMemberKey(me.id, me.port);
+        hashes[mixHash(key) % buckets] +=
+            (uint32_t)mixHash(key ^ mixHash(me.heartbeat));
+    }
+}
+
+/**
+ * FUNCTION NAME: handleRecvDigest
+ *
+ * DESCRIPTION: handle function for Receiving a push-pull digest, reply with
+ * the hashes and entries of the buckets that differ from ours
+ */
+void MP1Node::handleRecvDigest(Member *m, MessageHdr *msg, int msgSize) {
+    vector<MemberListEntry> digest;
+    vector<MemberListEntry> none;
+    char *data = (char *)msg + sizeof(MessageHdr);
+    unmarshall(data, msg->dataSize, msg->sentSize, digest, none);
+    if (digest.empty()) return;
+
+    // the bucket count comes off the wire, drop a digest that has none
+    size_t buckets = (uint16_t)digest[0].port;
+    if (buckets == 0 || buckets > DIGEST_MAX_BUCKETS) return;
+    vector<uint32_t> hashes;
+    computeDigest(buckets, hashes);
+
+    vector<bool> differs(buckets, false);
+    vector<MemberListEntry> mine;
+    for (auto &d : digest) {
+        size_t b = d.id;
+        if (b >= buckets || (uint32_t)d.heartbeat == hashes[b]) continue;
+        differs[b] = true;
+        mine.push_back(MemberListEntry(b, buckets, hashes[b], 0));
+    }
+    if (mine.empty()) return;
+
+    vector<MemberListEntry> entries;
+    for (auto &me : memberNode->memberList) {
+        if (differs[mixHash(getMemberKey(me.id, me.port)) % buckets]) {
+            entries.push_back(me);
+        }
+    }
+
+    // the differing buckets go in the sent section, which only the first
+    // frame carries, cut at half of it. That truncation is deliberate: our
+    // entries of every differing bucket still arrive, split over as many
+    // frames as they need, and the buckets that did not fit only miss the
+    // peer's push back, which its next DIGEST to us picks up again.
+    auto a = Address();
+    a.init();
+    memcpy(a.addr, msg->addr, ADDR_LEN);
+    sendMsg(&a, DIGESTREP, entries, mine, par->getcurrtime());
+}
+
+/**
+ * FUNCTION NAME: handleRecvDigestRep
+ *
+ * DESCRIPTION: handle function for Receiving the answer to a digest
+ * 				Applies the peer's entries, then sends back ours from
+ * the differing buckets that the peer lacks or is behind on. That push is a
+ * DIGESTREP without buckets, which ends the exchange.
+ */
+void MP1Node::handleRecvDigestRep(Member *m, MessageHdr *msg, int msgSize) {
+    vector<MemberListEntry> entries;
+    vector<MemberListEntry> theirs;
+    char *data = (char *)msg + sizeof(MessageHdr);
+    unmarshall(data, msg->dataSize, msg->sentSize, entries, theirs);
+
+    applyJoinedMembers(m, entries);
+    if (theirs.empty()) return;
+
+    size_t buckets = (uint16_t)theirs[0].port;
+    if (buckets == 0 || buckets > DIGEST_MAX_BUCKETS) return;
+    vector<bool> differs(buckets, false);
+    for (auto &d : theirs) {
+        if ((size_t)d.id < buckets) differs[d.id] = true;
+    }
+    unordered_map<uint64_t, long> known;
+    for (auto &e : entries) {
+        known[getMemberKey(e.id, e.port)] = e.heartbeat;
+    }
+
+    // entries past the first frame may cover some of these, which only
+    // costs a redundant push
+    vector<MemberListEntry> push;
+    for (auto &me : memberNode->memberList) {
+        auto key = getMemberKey(me.id, me.port);
+        if (!differs[mixHash(key) % buckets]) continue;
+        auto it = known.find(key);
+        if (it == known.end() || it->second < me.heartbeat) {
+            push.push_back(me);
+        }
+    }
+    if (push.empty()) return;
+
+    vector<MemberListEntry> none;
+    auto a = Address();
+    a.init();
+    memcpy(a.addr, msg->addr, ADDR_LEN);
+    sendMsg(&a, DIGESTREP, push, none, par->getcurrtime());
+}
+
+/**
+ * FUNCTION NAME: gossipFanout
+ *
+ * DESCRIPTION: members to gossip to per round
+ * 				ceil(log2 n) + GOSSIP_FANOUT_EXTRA unless GOSSIP_FANOUT
+ * fixes it, which is enough for a round to reach everyone with high
+ * probability while the load per node only grows with log n.
+ */
+int MP1Node::gossipFanout() {
+    if (par->GOSSIP_FANOUT > 0) return par->GOSSIP_FANOUT;
+    double n = max((size_t)2, memberNode->memberList.size());
+    return (int)ceil(log2(n)) + par->GOSSIP_FANOUT_EXTRA;
+}
+
+/**
+ * FUNCTION NAME: takeRound
+ *
+ * DESCRIPTION: whether gossip round of origin is new to this node, and if so
+ * remember it as forwarded
+ * 				Rounds of one origin are numbered by its clock, so a
+ * round no newer than the last one forwarded is a duplicate, or older news.
+ */
+bool MP1Node::takeRound(char *origin, long round) {
+    if (0 == memcmp(origin, memberNode->addr.addr, ADDR_LEN)) return false;
+
+    auto key = getMemberKey(getIdFromAddr(origin), getPortFromAddr(origin));
+    auto it = seenRounds.find(key);
+    if (it != seenRounds.end() && it->second >= round) return false;
+    seenRounds[key] = round;
+    return true;
+}
+
 /**
  * FUNCTION NAME: gossip
  *
- * DESCRIPTION: gossip protocol
+ * DESCRIPTION: gossip round of origin to at most fanout members, returns the
+ * number of members gossiped to
+ * 				Targets are picked with a partial Fisher-Yates shuffle
+ * over gossipOrder, so only as many slots as needed to find fanout
+ * non-excluded members are drawn. The permutation is kept between rounds
+ * since any permutation is a valid starting point.
  */
-void MP1Node::gossip(unordered_map<string, bool> &exclude, long timestamp) {
-    auto randomOrder(memberNode->memberList);
+int MP1Node::gossip(const unordered_set<uint64_t> &exclude, char *origin,
+                    long round, int fanout) {
+    auto &memberList = memberNode->memberList;
+    size_t n = memberList.size();
 
-    // shuffle
-    std::random_device rd;
-    auto rng = std::default_random_engine(rd());
-    shuffle(randomOrder.begin(), randomOrder.end(), rng);
+    syncGossipOrder();
 
-    string idAndPort = "";
-    MemberListEntry me;
     vector<MemberListEntry> to_be_sent;
-    for (decltype(randomOrder.size()) i = 0;
-         i < randomOrder.size() && to_be_sent.size() < GOSSIP_NUM; ++i) {
-        me = randomOrder[i];
-        idAndPort = getIdAndPortString(me.getid(), me.getport());
-        if (exclude[idAndPort]) continue;
+    for (size_t i = 0; i < n && to_be_sent.size() < (size_t)fanout; ++i) {
+        size_t j = i + rng.nextInt(n - i);
+        swap(gossipOrder[i], gossipOrder[j]);
+
+        auto &me = memberList[gossipOrder[i]];
+        if (exclude.count(getMemberKey(me.getid(), me.getport()))) continue;
 
         to_be_sent.push_back(me);
     }
 
     vector<MemberListEntry> sent = to_be_sent;
-    for (auto e : exclude) {
-        string idAndPort = e.first;
+    for (auto key : exclude) {
         int id;
         short port;
-        loadIdAndPortFromString(idAndPort, id, port);
+        loadIdAndPortFromKey(key, id, port);
         sent.push_back(MemberListEntry(id, port));
     }
 
+    vector<MemberListEntry> entries;
     for (auto me : to_be_sent) {
         auto addr = Address();
-        memset(&addr, 0, sizeof(Address));
+        addr.init();
         loadAddr(&addr, me.getid(), me.getport());
-        sendMsg(&addr, GOSSIP, sent, timestamp);
+
+        entries.clear();
+        collectGossipEntries(getMemberKey(me.getid(), me.getport()), entries);
+        sendMsg(&addr, GOSSIP, entries, sent, round, origin);
+    }
+
+    return to_be_sent.size();
+}
+
+/**
+ * FUNCTION NAME: syncGossipOrder
+ *
+ * DESCRIPTION: make gossipOrder a permutation of the current memberList
+ * indices again after members were added or removed
+ * 				A rebuild after a removal ends the current probe pass,
+ * so the next probe reshuffles instead of walking the list in index order.
+ */
+void MP1Node::syncGossipOrder() {
+    size_t n = memberNode->memberList.size();
+    bool rebuilt = gossipOrder.size() > n;
+    if (rebuilt) gossipOrder.clear();
+    while (gossipOrder.size() < n) {
+        gossipOrder.push_back(gossipOrder.size());
+    }
+    if (rebuilt) probeIndex = gossipOrder.size();
+}
+
+/**
+ * FUNCTION NAME: collectGossipEntries
+ *
+ * DESCRIPTION: fill entries with what peer should be told
+ * 				A peer that has never been gossiped to, or whose last
+ * full sync is FULL_SYNC_INTERVAL old, gets the whole list. Otherwise only
+ * entries whose version is newer than the last gossip to it are sent. With
+ * anti-entropy on, the periodic full sync is left to the push-pull exchange.
+ */
+void MP1Node::collectGossipEntries(uint64_t peer,
+                                   vector<MemberListEntry> &entries) {
+    long curTime = par->getcurrtime();
+    auto it = gossipPeers.find(peer);
+    bool full = it == gossipPeers.end() ||
+                (par->ANTI_ENTROPY_INTERVAL <= 0 &&
+                 curTime - it->second.lastFullSync >= FULL_SYNC_INTERVAL);
+
+    if (full) {
+        entries = memberNode->memberList;
+        gossipPeers[peer] = GossipPeer{memberVersion, curTime};
+        return;
+    }
+
+    auto &memberList = memberNode->memberList;
+    for (size_t i = 0; i < memberList.size(); ++i) {
+        if (memberVersions[i] > it->second.lastVersion) {
+            entries.push_back(memberList[i]);
+        }
+    }
+    it->second.lastVersion = memberVersion;
+}
+
+/**
+ * FUNCTION NAME: swimLoopOps
+ *
+ * DESCRIPTION: SWIM protocol duties, run instead of heartbeat gossip
+ * 				Every SWIM_PERIOD one member is probed with a PING. If
+ * no ACK arrives within SWIM_ACK_TIMEOUT, SWIM_PING_REQ_NUM members are asked
+ * to probe it with a PINGREQ. If the period ends without any ACK, the
+ * member becomes suspect, and it is declared failed unless it refutes within
+ * the suspicion timeout. Joins and failures travel piggybacked on these
+ * messages, so the load per node does not depend on the group size.
+ */
+void MP1Node::swimLoopOps() {
+    long curTime = par->getcurrtime();
+    int myId = getIdFromAddr(memberNode->addr.addr);
+    short myPort = getPortFromAddr(memberNode->addr.addr);
+
+    // the ring of MP2 expects this node in its own list
+    if (findMember(myId, myPort) == NULL) {
+        addMember(
+            MemberListEntry(myId, myPort, memberNode->heartbeat, curTime));
+    }
+
+    if (probeInProgress) {
+        if (!probeAcked && !pingReqSent &&
+            curTime - probeStart >= SWIM_ACK_TIMEOUT) {
+            sendPingReqs();
+            pingReqSent = true;
+        }
+        if (curTime - probeStart >= SWIM_PERIOD) {
+            // an unhealthy node gives the target longer, the ack may be
+            // sitting unread in its own queue
+            if (!probeAcked) {
+                lateProbes.push_back(LateProbe{
+                    probeTarget, probeStart + healthScaled(SWIM_PERIOD)});
+            }
+            adjustLocalHealth(probeAcked ? -1 : 1);
+            probeInProgress = false;
+        }
     }
 
+    // probes still without an ack make their target suspect
+    for (size_t i = 0; i < lateProbes.size();) {
+        if (curTime < lateProbes[i].deadline) {
+            ++i;
+            continue;
+        }
+        int id;
+        short port;
+        loadIdAndPortFromKey(lateProbes[i].target, id, port);
+        lateProbes[i] = lateProbes.back();
+        lateProbes.pop_back();
+        auto *me = findMember(id, port);
+        if (me) applySwimUpdate(id, port, me->heartbeat, MEMBER_SUSPECT, true);
+    }
+
+    // suspects that did not refute in time are declared failed
+    long timeout = suspicionTimeout(SWIM_PERIOD);
+    auto &memberList = memberNode->memberList;
+    for (size_t i = 0; i < memberList.size();) {
+        if (suspectSince[i] < 0 || curTime - suspectSince[i] < timeout) {
+            ++i;
+            continue;
+        }
+        // the last entry moves into slot i, so look at i again
+        auto &m = memberList[i];
+        applySwimUpdate(m.getid(), m.getport(), m.getheartbeat(), MEMBER_DEAD,
+                        true);
+    }
+    expireDeadMembers(curTime, SWIM_PERIOD);
+
+    uint64_t key;
+    if (!probeInProgress && nextProbeTarget(key)) {
+        probeTarget = key;
+        probeStart = curTime;
+        probeInProgress = true;
+        probeAcked = false;
+        pingReqSent = false;
+
+        auto addr = Address();
+        addr.init();
+        int id;
+        short port;
+        loadIdAndPortFromKey(key, id, port);
+        loadAddr(&addr, id, port);
+        sendSwimMsg(&addr, PING, NULL);
+    }
+
+    // an ACK that did not come back within a period will not be relayed
+    pingReqRelays.erase(
+        remove_if(pingReqRelays.begin(), pingReqRelays.end(),
+                  [curTime](const PingReqRelay &r) {
+                      return curTime - r.timestamp >= SWIM_PERIOD;
+                  }),
+        pingReqRelays.end());
+
     return;
 }
 
+/**
+ * FUNCTION NAME: nextProbeTarget
+ *
+ * DESCRIPTION: pick the next member to probe
+ * 				Members are probed round-robin over gossipOrder, which
+ * is reshuffled after every full pass, so each member is probed once per
+ * pass in random order.
+ */
+bool MP1Node::nextProbeTarget(uint64_t &key) {
+    auto &memberList = memberNode->memberList;
+    uint64_t self = getMemberKey(getIdFromAddr(memberNode->addr.addr),
+                                 getPortFromAddr(memberNode->addr.addr));
+
+    syncGossipOrder();
+    for (size_t tries = 0; tries < memberList.size(); ++tries) {
+        if (probeIndex >= gossipOrder.size()) {
+            shuffle(gossipOrder.begin(), gossipOrder.end(), rng);
+            probeIndex = 0;
+        }
+        auto &me = memberList[gossipOrder[probeIndex++]];
+        key = getMemberKey(me.getid(), me.getport());
+        if (key != self) return true;
+    }
+
+    return false;
+}
+
+/**
+ * FUNCTION NAME: sendPingReqs
+ *
+ * DESCRIPTION: ask up to SWIM_PING_REQ_NUM random members to probe the
+ * current probe target
+ */
+void MP1Node::sendPingReqs() {
+    auto &memberList = memberNode->memberList;
+    uint64_t self = getMemberKey(getIdFromAddr(memberNode->addr.addr),
+                                 getPortFromAddr(memberNode->addr.addr));
+
+    auto target = Address();
+    target.init();
+    int id;
+    short port;
+    loadIdAndPortFromKey(probeTarget, id, port);
+    loadAddr(&target, id, port);
+
+    vector<uint64_t> helpers;
+    for (size_t tries = 0; tries < 4 * SWIM_PING_REQ_NUM &&
+                           helpers.size() < SWIM_PING_REQ_NUM &&
+                           !memberList.empty();
+         ++tries) {
+        auto &me = memberList[rng.nextInt(memberList.size())];
+        uint64_t key = getMemberKey(me.getid(), me.getport());
+        if (key == self || key == probeTarget ||
+            find(helpers.begin(), helpers.end(), key) != helpers.end())
+            continue;
+
+        helpers.push_back(key);
+        auto addr = Address();
+        addr.init();
+        loadAddr(&addr, me.getid(), me.getport());
+        sendSwimMsg(&addr, PINGREQ, &target);
+    }
+}
+
+/**
+ * FUNCTION NAME: handleRecvSwimMsg
+ *
+ * DESCRIPTION: handle function for Receiving PING, PINGREQ and ACK
+ */
+void MP1Node::handleRecvSwimMsg(Member *m, MessageHdr *msg, int msgSize) {
+    vector<MemberListEntry> alive;
+    vector<MemberListEntry> failed;
+    char *data = (char *)msg + sizeof(MessageHdr);
+    unmarshall(data, msg->dataSize, msg->sentSize, alive, failed);
+
+    // the sender always includes itself in the alive list
+    for (auto &e : alive) {
+        applySwimUpdate(e.id, e.port, e.heartbeat, MEMBER_ALIVE, true);
+    }
+    for (auto &e : failed) {
+        applySwimUpdate(e.id, e.port, e.heartbeat / 2,
+                        e.heartbeat % 2 ? MEMBER_DEAD : MEMBER_SUSPECT, true);
+    }
+
+    auto sender = Address();
+    sender.init();
+    memcpy(sender.addr, msg->addr, ADDR_LEN);
+    uint64_t target =
+        getMemberKey(getIdFromAddr(msg->target), getPortFromAddr(msg->target));
+
+    switch (msg->msgType) {
+        case PING:
+            sendSwimMsg(&sender, ACK, &m->addr);
+            break;
+
+        case PINGREQ: {
+            pingReqRelays.push_back(PingReqRelay{
+                target,
+                getMemberKey(getIdFromAddr(msg->addr),
+                             getPortFromAddr(msg->addr)),
+                par->getcurrtime()});
+
+            auto addr = Address();
+            addr.init();
+            memcpy(addr.addr, msg->target, ADDR_LEN);
+            sendSwimMsg(&addr, PING, NULL);
+            break;
+        }
+
+        case ACK: {
+            if (probeInProgress && target == probeTarget) {
+                probeAcked = true;
+            }
+            lateProbes.erase(remove_if(lateProbes.begin(), lateProbes.end(),
+                                       [target](const LateProbe &p) {
+                                           return p.target == target;
+                                       }),
+                             lateProbes.end());
+
+            // pass the ACK on to whoever asked for this probe
+            auto targetAddr = Address();
+            targetAddr.init();
+            memcpy(targetAddr.addr, msg->target, ADDR_LEN);
+            for (size_t i = 0; i < pingReqRelays.size();) {
+                if (pingReqRelays[i].target != target) {
+                    ++i;
+                    continue;
+                }
+                auto addr = Address();
+                addr.init();
+                int id;
+                short port;
+                loadIdAndPortFromKey(pingReqRelays[i].requester, id, port);
+                loadAddr(&addr, id, port);
+                sendSwimMsg(&addr, ACK, &targetAddr);
+
+                pingReqRelays[i] = pingReqRelays.back();
+                pingReqRelays.pop_back();
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return;
+}
+
+/**
+ * FUNCTION NAME: applySwimUpdate
+ *
+ * DESCRIPTION: apply an alive, suspect or failed update about a member
+ * 				A higher incarnation wins. At equal incarnation suspect
+ * wins over alive, and a failure wins over both. A suspect member that does
+ * not refute within the suspicion timeout is declared failed. A node told
+ * that it is suspected refutes it by announcing itself alive with a higher
+ * incarnation.
+ */
+void MP1Node::applySwimUpdate(int id, short port, long incarnation,
+                              MemberState state, bool disseminate) {
+    uint64_t key = getMemberKey(id, port);
+    long curTime = par->getcurrtime();
+
+    if (id == getIdFromAddr(memberNode->addr.addr) &&
+        port == getPortFromAddr(memberNode->addr.addr)) {
+        if (state != MEMBER_ALIVE && incarnation >= memberNode->heartbeat) {
+            memberNode->heartbeat = incarnation + 1;
+            adjustLocalHealth(1);
+            auto *me = findMember(id, port);
+            if (me) {
+                me->setheartbeat(memberNode->heartbeat);
+                touchMember(me);
+            }
+            queueSwimUpdate(id, port, memberNode->heartbeat, MEMBER_ALIVE);
+        }
+        return;
+    }
+
+    auto addr = Address();
+    addr.init();
+    loadAddr(&addr, id, port);
+    auto *me = findMember(id, port);
+    size_t slot = me ? me - memberNode->memberList.data() : 0;
+    auto dead = deadMembers.find(key);
+
+    switch (state) {
+        case MEMBER_ALIVE:
+            if (dead != deadMembers.end() &&
+                dead->second.heartbeat >= incarnation)
+                return;
+
+            if (me) {
+                if (incarnation <= me->heartbeat) return;
+                me->setheartbeat(incarnation);
+                me->settimestamp(curTime);
+                suspectSince[slot] = -1;
+                touchMember(me);
+            } else {
+                if (dead != deadMembers.end()) deadMembers.erase(dead);
+                addMember(MemberListEntry(id, port, incarnation, curTime));
+                log->logNodeAdd(&memberNode->addr, &addr);
+            }
+            break;
+
+        case MEMBER_SUSPECT:
+            if (!me || incarnation < me->heartbeat) return;
+            if (incarnation == me->heartbeat && suspectSince[slot] >= 0)
+                return;
+
+            me->setheartbeat(incarnation);
+            suspectSince[slot] = curTime;
+            break;
+
+        case MEMBER_DEAD:
+            if (me) {
+                if (incarnation < me->heartbeat) return;
+                log->logNodeRemove(&memberNode->addr, &addr);
+                removeMember(slot);
+            } else if (dead != deadMembers.end() &&
+                       dead->second.heartbeat >= incarnation) {
+                return;
+            }
+            deadMembers[key] = DeadMember{incarnation, curTime};
+            break;
+    }
+
+    if (disseminate) queueSwimUpdate(id, port, incarnation, state);
+}
+
+/**
+ * FUNCTION NAME: queueSwimUpdate
+ *
+ * DESCRIPTION: queue an update for piggybacking, replacing any older update
+ * about the same member
+ */
+void MP1Node::queueSwimUpdate(int id, short port, long incarnation,
+                              MemberState state) {
+    for (auto &u : swimUpdates) {
+        if (u.id == id && u.port == port) {
+            u = SwimUpdate{id, port, incarnation, state, 0};
+            return;
+        }
+    }
+    swimUpdates.push_back(SwimUpdate{id, port, incarnation, state, 0});
+}
+
+/**
+ * FUNCTION NAME: collectSwimUpdates
+ *
+ * DESCRIPTION: pick the SWIM_MAX_PIGGYBACK least sent updates for the next
+ * message, and forget the ones sent SWIM_RETRANSMIT_MULT * log2(n) times
+ * 				Suspect and failed updates share the failed list, the
+ * low bit of the incarnation tells them apart.
+ */
+void MP1Node::collectSwimUpdates(vector<MemberListEntry> &alive,
+                                 vector<MemberListEntry> &failed) {
+    size_t n = min(swimUpdates.size(), (size_t)SWIM_MAX_PIGGYBACK);
+    partial_sort(swimUpdates.begin(), swimUpdates.begin() + n,
+                 swimUpdates.end(),
+                 [](const SwimUpdate &a, const SwimUpdate &b) {
+                     return a.sent < b.sent;
+                 });
+
+    for (size_t i = 0; i < n; ++i) {
+        auto &u = swimUpdates[i];
+        if (u.state == MEMBER_ALIVE) {
+            alive.push_back(MemberListEntry(u.id, u.port, u.incarnation, 0));
+        } else {
+            failed.push_back(MemberListEntry(
+                u.id, u.port, u.incarnation * 2 + (u.state == MEMBER_DEAD),
+                0));
+        }
+        u.sent++;
+    }
+
+    size_t limit = SWIM_RETRANSMIT_MULT *
+                   (size_t)ceil(log2(memberNode->memberList.size() + 1));
+    swimUpdates.erase(remove_if(swimUpdates.begin(), swimUpdates.end(),
+                                [limit](const SwimUpdate &u) {
+                                    return u.sent >= limit;
+                                }),
+                      swimUpdates.end());
+}
+
+/**
+ * FUNCTION NAME: sendSwimMsg
+ *
+ * DESCRIPTION: send a PING, PINGREQ or ACK with piggybacked updates
+ * 				The data section holds alive updates, starting with
+ * this node itself, and the sent section holds suspect and failed members.
+ * A suspect receiver always finds its own suspicion in there (Lifeguard's
+ * buddy system).
+ */
+void MP1Node::sendSwimMsg(Address *addr, MsgTypes ms, Address *target) {
+    vector<MemberListEntry> alive{
+        MemberListEntry(getIdFromAddr(memberNode->addr.addr),
+                        getPortFromAddr(memberNode->addr.addr),
+                        memberNode->heartbeat, 0)};
+    vector<MemberListEntry> failed;
+    collectSwimUpdates(alive, failed);
+    // tell a suspect member about it directly, so it can refute in time
+    auto *dst =
+        findMember(getIdFromAddr(addr->addr), getPortFromAddr(addr->addr));
+    if (dst && suspectSince[dst - memberNode->memberList.data()] >= 0) {
+        failed.push_back(MemberListEntry(dst->id, dst->port,
+                                         dst->heartbeat * 2, 0));
+    }
+    sortEntries(alive);
+    sortEntries(failed);
+
+    size_t budget = frameBudget();
+    if (budget == 0) return;
+    MessageHdr *msg = static_cast<MessageHdr *>(malloc(par->MAX_MSG_SIZE));
+    memset(msg, 0, sizeof(MessageHdr));
+    char *data = (char *)msg + sizeof(MessageHdr);
+
+    size_t next = 0;
+    size_t sentSize = marshallEntries(data, failed, next, budget / 2);
+    next = 0;
+    size_t dataSize =
+        marshallEntries(data + sentSize, alive, next, budget - sentSize);
+
+    memcpy(msg->addr, memberNode->addr.addr, ADDR_LEN);
+    if (target) memcpy(msg->target, target->addr, ADDR_LEN);
+    msg->msgType = ms;
+    msg->timestamp = par->getcurrtime();
+    msg->dataSize = dataSize;
+    msg->sentSize = sentSize;
+
+    emulNet->ENsend(&memberNode->addr, addr, (char *)msg,
+                    sizeof(MessageHdr) + sentSize + dataSize);
+    free(msg);
+}
+
 /**
  * FUNCTION NAME: isNullAddress
  *
@@ -447,6 +1584,25 @@ int MP1Node::isNullAddress(Address *addr) {
     return (memcmp(addr->addr, NULLADDR, ADDR_LEN) == 0 ? 1 : 0);
 }
 
+/**
+ * FUNCTION NAME: getIntroducerAddress
+ *
+ * DESCRIPTION: Returns the Address this node sends its JOINREQ to
+ * 				With INTRODUCERS k, nodes 1..k introduce the others,
+ * spread by id so no single node takes every join. Nodes 2..k themselves
+ * join through the coordinator.
+ */
+Address MP1Node::getIntroducerAddress() {
+    Address joinaddr = getJoinAddress();
+    int id = getIdFromAddr(memberNode->addr.addr);
+
+    if (par->INTRODUCERS > 1 && id > par->INTRODUCERS) {
+        *(int *)(&joinaddr.addr) = 1 + id % par->INTRODUCERS;
+    }
+
+    return joinaddr;
+}
+
 /**
  * FUNCTION NAME: getJoinAddress
  *
@@ -455,7 +1611,7 @@ int MP1Node::isNullAddress(Address *addr) {
 Address MP1Node::getJoinAddress() {
     Address joinaddr;
 
-    memset(&joinaddr, 0, sizeof(Address));
+    joinaddr.init();
     *(int *)(&joinaddr.addr) = 1;
     *(short *)(&joinaddr.addr[4]) = 0;
 
@@ -469,6 +1625,23 @@ Address MP1Node::getJoinAddress() {
  */
 void MP1Node::initMemberListTable(Member *memberNode) {
     memberNode->memberList.clear();
+    memberIndex.clear();
+    memberVersions.clear();
+    suspectSince.clear();
+    detectors.clear();
+    deadMembers.clear();
+    gossipPeers.clear();
+    seenRounds.clear();
+    gossipOrder.clear();
+    probeIndex = 0;
+    probeInProgress = false;
+    lateProbes.clear();
+    newJoins.clear();
+    relayedJoins.clear();
+    introduced.clear();
+    localHealth = 0;
+    swimUpdates.clear();
+    pingReqRelays.clear();
 }
 
 /**
@@ -507,6 +1680,18 @@ void MP1Node::loadAddr(Address *addr, int id, short port) {
     memcpy(&addr->addr[4], &port, sizeof(short));
 }
 
+/**
+ * FUNCTION NAME: frameBudget
+ *
+ * DESCRIPTION: bytes of entries a message can carry within MAX_MSG_SIZE, 0
+ * 				when MAX_MSG_SIZE leaves no room for a single entry
+ */
+size_t MP1Node::frameBudget() {
+    long budget = (long)par->MAX_MSG_SIZE - (long)sizeof(en_msg) -
+                  (long)sizeof(MessageHdr) - 1;
+    return budget < MAX_ENCODED_FRAME_SIZE ? 0 : (size_t)budget;
+}
+
 /**
  * FUNCTION NAME: sendMsg
  *
@@ -528,93 +1713,84 @@ void MP1Node::sendMsg(Address *addr, MsgTypes ms) {
  * FUNCTION NAME: sendMsg
  *
  * DESCRIPTION: send message to the address for gossip
+ * 				origin is the member that started the gossip round,
+ * this node when NULL.
  */
-void MP1Node::sendMsg(Address *addr, MsgTypes ms, vector<MemberListEntry> &sent,
-                      long timestamp) {
-    // gossip msg includes member list and sent list
-    // MessageHdr + addrs + sent
-    size_t dataSize = DATA_FRAME_SIZE * memberNode->memberList.size();
-
-    size_t sentSize = DATA_FRAME_SIZE * sent.size();
-
-    size_t msgSize = sizeof(MessageHdr) + dataSize + sentSize + 1;
-    MessageHdr *msg = static_cast<MessageHdr *>(malloc(msgSize));
-    memset(msg, 0, msgSize);
-
-    marshall((char *)msg + sizeof(MessageHdr), memberNode->memberList, sent);
-    msg->dataSize = dataSize;
-    msg->sentSize = sentSize;
-
-    memcpy(msg->addr, memberNode->addr.addr, ADDR_LEN);
-    msg->msgType = ms;
-    msg->timestamp = timestamp;
-
-    emulNet->ENsend(&memberNode->addr, addr, (char *)msg, msgSize);
-    delete msg;
+void MP1Node::sendMsg(Address *addr, MsgTypes ms,
+                      vector<MemberListEntry> &entries,
+                      vector<MemberListEntry> &sent, long timestamp,
+                      char *origin) {
+    // gossip msg includes member entries and sent list
+    // MessageHdr + sent + addrs, split into frames that fit MAX_MSG_SIZE.
+    // The sent list only goes in the first frame and may use at most half
+    // of it, since it is only a hint of who already got this gossip.
+    size_t budget = frameBudget();
+    if (budget == 0) return;
+    MessageHdr *msg = static_cast<MessageHdr *>(malloc(par->MAX_MSG_SIZE));
+
+    sortEntries(entries);
+    sortEntries(sent);
+
+    size_t next = 0;
+    size_t sentNext = 0;
+    unsigned int fragment = 0;
+    do {
+        memset(msg, 0, sizeof(MessageHdr));
+        char *data = (char *)msg + sizeof(MessageHdr);
+
+        size_t sentSize = 0;
+        if (fragment == 0) {
+            sentSize = marshallEntries(data, sent, sentNext, budget / 2);
+        }
+        size_t first = next;
+        size_t dataSize = marshallEntries(data + sentSize, entries, next,
+                                          budget - sentSize);
+        // an entry that does not fit an empty frame can never be sent
+        if (fragment > 0 && next == first) break;
+
+        memcpy(msg->addr, memberNode->addr.addr, ADDR_LEN);
+        msg->msgType = ms;
+        msg->timestamp = timestamp;
+        msg->dataSize = dataSize;
+        msg->sentSize = sentSize;
+        msg->fragment = fragment++;
+        memcpy(msg->target, origin ? origin : memberNode->addr.addr, ADDR_LEN);
+
+        size_t msgSize = sizeof(MessageHdr) + sentSize + dataSize;
+        emulNet->ENsend(&memberNode->addr, addr, (char *)msg, msgSize);
+    } while (next < entries.size());
+
+    free(msg);
 }
 
 /**
- * FUNCTION NAME: getIdAndPortString
+ * FUNCTION NAME: getMemberKey
  *
- * DESCRIPTION: convert id and port to string and concat them
+ * DESCRIPTION: pack id and port into a single integer key
  */
-string MP1Node::getIdAndPortString(int id, short port) {
-    return to_string(id) + ":" + to_string(port);
+uint64_t MP1Node::getMemberKey(int id, short port) {
+    return ((uint64_t)(uint32_t)id << 16) | (uint16_t)port;
 }
 
 /**
- * FUNCTION NAME: loadIdAndPortFromString
+ * FUNCTION NAME: mixHash
  *
- * DESCRIPTION: load id and port from idAndPort string
+ * DESCRIPTION: splitmix64 finalizer, spreads the bits of x over the result
  */
-void MP1Node::loadIdAndPortFromString(string idAndPort, int &id, short &port) {
-    auto id_pos = idAndPort.find(":");
-    auto id_string = idAndPort.substr(0, id_pos);
-    auto port_string = idAndPort.substr(id_pos + 1);
-
-    id = stoi(id_string);
-    port = stoi(port_string);
-
-    return;
+uint64_t MP1Node::mixHash(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
 }
 
 /**
- * FUNCTION NAME: marshall
+ * FUNCTION NAME: loadIdAndPortFromKey
  *
- * DESCRIPTION: convert adresses into byte array
+ * DESCRIPTION: load id and port from a key built by getMemberKey
  */
-void MP1Node::marshall(char *_dest, vector<MemberListEntry> &m,
-                       vector<MemberListEntry> &sent) {
-    auto ind = 0;
-    Address a = Address();
-    memset(&a, 0, sizeof(Address));
-
-    for (auto me : m) {
-        loadAddr(&a, me.getid(), me.getport());
-
-        // addr
-        memcpy(_dest + ind, a.addr, ADDR_LEN);
-        ind += ADDR_LEN;
-
-        // heartbeat
-        long hb = me.getheartbeat();
-        memcpy(_dest + ind, &hb, sizeof(long));
-        ind += sizeof(long);
-        _dest[ind++] = ',';
-    }
-
-    for (auto s : sent) {
-        loadAddr(&a, s.getid(), s.getport());
-
-        // addr
-        memcpy(_dest + ind, a.addr, ADDR_LEN);
-        ind += ADDR_LEN;
-
-        // heartbeat
-        memcpy(_dest + ind, &s.heartbeat, sizeof(long));
-        ind += sizeof(long);
-        _dest[ind++] = ',';
-    }
+void MP1Node::loadIdAndPortFromKey(uint64_t key, int &id, short &port) {
+    id = (int)(uint32_t)(key >> 16);
+    port = (short)(uint16_t)(key & 0xffff);
 
     return;
 }
@@ -622,46 +1798,128 @@ void MP1Node::marshall(char *_dest, vector<MemberListEntry> &m,
 /**
  * FUNCTION NAME: unmarshall
  *
- * DESCRIPTION: convert byte array into addresses
+ * DESCRIPTION: convert byte array into sent list and member entries
  */
 void MP1Node::unmarshall(char *_src, size_t dataSize, size_t sentSize,
                          vector<MemberListEntry> &m,
                          vector<MemberListEntry> &sent) {
-    size_t mleSize = dataSize / DATA_FRAME_SIZE;
-    long heartbeat;
+    unmarshallEntries(_src, sentSize, sent);
+    unmarshallEntries(_src + sentSize, dataSize, m);
 
-    char addr[ADDR_LEN];
-    for (decltype(mleSize) i = 0; i < mleSize; ++i) {
-        // dataFrameSize = ADDR_LEN + sizeof(long) + 1
-
-        memcpy(addr, _src, ADDR_LEN);
-        _src += ADDR_LEN;
-        memcpy(&heartbeat, _src, sizeof(long));
-        _src += sizeof(long);
+    return;
+}
 
-        m.push_back(MemberListEntry(getIdFromAddr(addr), getPortFromAddr(addr),
-                                    heartbeat, par->getcurrtime()));
+/**
+ * FUNCTION NAME: sortEntries
+ *
+ * DESCRIPTION: sort entries by (id, port), as marshallEntries expects
+ */
+void MP1Node::sortEntries(vector<MemberListEntry> &m) {
+    sort(m.begin(), m.end(),
+         [](const MemberListEntry &a, const MemberListEntry &b) {
+             return getMemberKey(a.id, a.port) < getMemberKey(b.id, b.port);
+         });
+}
 
-        // for `,`
-        ++_src;
+/**
+ * FUNCTION NAME: marshallEntries
+ *
+ * DESCRIPTION: encode sorted entries from m[next] on as varints
+ * 				Each entry is the id delta from the previous entry,
+ * the port, and the zigzag encoded heartbeat delta from the previous entry.
+ * Ids are dense and heartbeats of live members are close to each other, so
+ * most entries take 3 or 4 bytes instead of a fixed 15. Stops before
+ * the first entry that would go past limit bytes and leaves next there.
+ *
+ * RETURNS:
+ * number of bytes written
+ */
+size_t MP1Node::marshallEntries(char *_dest, vector<MemberListEntry> &m,
+                                size_t &next, size_t limit) {
+    auto *dest = (uint8_t *)_dest;
+    uint8_t frame[MAX_ENCODED_FRAME_SIZE];
+    uint32_t prevId = 0;
+    long prevHeartbeat = 0;
+    size_t size = 0;
+    for (; next < m.size(); ++next) {
+        auto &me = m[next];
+        long delta = me.heartbeat - prevHeartbeat;
+        auto *end = putVarint(frame, (uint32_t)me.id - prevId);
+        end = putVarint(end, (uint16_t)me.port);
+        end = putVarint(end, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+
+        size_t frameSize = end - frame;
+        if (size + frameSize > limit) break;
+        memcpy(dest + size, frame, frameSize);
+        size += frameSize;
+
+        prevId = (uint32_t)me.id;
+        prevHeartbeat = me.heartbeat;
     }
 
-    size_t sentNum = sentSize / DATA_FRAME_SIZE;
-    for (decltype(sentNum) i = 0; i < sentNum; ++i) {
-        // dataFrameSize = ADDR_LEN + sizeof(long) + 1
+    return size;
+}
 
-        memcpy(addr, _src, ADDR_LEN);
-        _src += ADDR_LEN;
-        memcpy(&heartbeat, _src, sizeof(long));
-        _src += sizeof(long);
+/**
+ * FUNCTION NAME: unmarshallEntries
+ *
+ * DESCRIPTION: decode size bytes written by marshallEntries
+ */
+void MP1Node::unmarshallEntries(char *_src, size_t size,
+                                vector<MemberListEntry> &m) {
+    auto *src = (const uint8_t *)_src;
+    auto *end = src + size;
+    uint64_t idDelta, port, zigzag;
+    uint32_t id = 0;
+    long heartbeat = 0;
+
+    while (src < end) {
+        src = getVarint(src, end, idDelta);
+        src = getVarint(src, end, port);
+        src = getVarint(src, end, zigzag);
+        if (src == NULL) return;
+
+        id += (uint32_t)idDelta;
+        heartbeat += (long)((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+        m.push_back(MemberListEntry((int)id, (short)port, heartbeat,
+                                    par->getcurrtime()));
+    }
 
-        sent.push_back(MemberListEntry(getIdFromAddr(addr),
-                                       getPortFromAddr(addr), heartbeat,
-                                       par->getcurrtime()));
+    return;
+}
 
-        // for `,`
-        ++_src;
+/**
+ * FUNCTION NAME: putVarint
+ *
+ * DESCRIPTION: write v as LEB128, 7 bits per byte
+ *
+ * RETURNS:
+ * position after the last byte written
+ */
+uint8_t *MP1Node::putVarint(uint8_t *dest, uint64_t v) {
+    while (v >= 0x80) {
+        *dest++ = (uint8_t)(v | 0x80);
+        v >>= 7;
     }
+    *dest++ = (uint8_t)v;
+    return dest;
+}
 
-    return;
+/**
+ * FUNCTION NAME: getVarint
+ *
+ * DESCRIPTION: read a LEB128 value written by putVarint
+ *
+ * RETURNS:
+ * position after the value, NULL if it runs past end
+ */
+const uint8_t *MP1Node::getVarint(const uint8_t *src, const uint8_t *end,
+                                  uint64_t &v) {
+    v = 0;
+    for (int shift = 0; src != NULL && src < end && shift < 64; shift += 7) {
+        uint8_t b = *src++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return src;
+    }
+    return NULL;
 }
@@ -9,12 +9,15 @@
 #define _MP1NODE_H_
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include "EmulNet.h"
 #include "Log.h"
 #include "Member.h"
 #include "Params.h"
+#include "PhiAccrual.h"
 #include "Queue.h"
+#include "Random.h"
 #include "stdincludes.h"
 
 /**
@@ -23,8 +26,26 @@
 #define TREMOVE 20
 #define TFAIL 5
 #define ADDR_LEN 6
-#define GOSSIP_NUM (par->EN_GPSZ) / 3
-#define DATA_FRAME_SIZE (ADDR_LEN + sizeof(long) + 1)
+// varint encoded entry: id delta, port and zigzag heartbeat delta
+#define MAX_ENCODED_FRAME_SIZE (5 + 3 + 10)
+// a peer gets the whole membership list at least this often, unless
+// push-pull anti-entropy repairs what deltas miss
+#define FULL_SYNC_INTERVAL 20
+// anti-entropy: members per digest bucket, and most buckets in a digest
+#define DIGEST_BUCKET_SIZE 8
+#define DIGEST_MAX_BUCKETS 256
+// SWIM: time units per protocol period, enough for an indirect probe
+#define SWIM_PERIOD 6
+// SWIM: time units to wait for a direct ack before asking for help
+#define SWIM_ACK_TIMEOUT 2
+// SWIM: members asked to probe the target indirectly
+#define SWIM_PING_REQ_NUM 3
+// SWIM: membership updates piggybacked on each message
+#define SWIM_MAX_PIGGYBACK 8
+// SWIM: each update is piggybacked this many times log2(group size)
+#define SWIM_RETRANSMIT_MULT 3
+// highest local health score, timeouts stretch up to (LHM_MAX + 1) times
+#define LHM_MAX 8
 
 /*
  * Note: You can change/add any functions in MP1Node.{h,cpp}
@@ -33,7 +54,24 @@
 /**
  * Message Types
  */
-enum MsgTypes { JOINREQ, JOINREP, GOSSIP, DUMMYLASTMSGTYPE };
+enum MsgTypes {
+    JOINREQ,
+    JOINREP,
+    GOSSIP,
+    SYNCREQ,
+    JOINANN,
+    DIGEST,
+    DIGESTREP,
+    PING,
+    PINGREQ,
+    ACK,
+    DUMMYLASTMSGTYPE
+};
+
+/**
+ * State of a member as seen by this node
+ */
+enum MemberState { MEMBER_ALIVE, MEMBER_SUSPECT, MEMBER_DEAD };
 
 /**
  * STRUCT NAME: MessageHdr
@@ -46,8 +84,72 @@ typedef struct MessageHdr {
     long timestamp;
     size_t dataSize;
     size_t sentSize;
+    // index of this frame when a gossip is split, the sent list is only in 0
+    unsigned int fragment;
+    // SWIM: member to probe for a PINGREQ, member that answered for an ACK.
+    // GOSSIP: member that started the round, which timestamp numbers
+    char target[ADDR_LEN];
 } MessageHdr;
 
+/**
+ * STRUCT NAME: GossipPeer
+ *
+ * DESCRIPTION: What was last gossiped to a peer, used to send it only the
+ * entries that changed since
+ */
+typedef struct GossipPeer {
+    uint64_t lastVersion;
+    long lastFullSync;
+} GossipPeer;
+
+/**
+ * STRUCT NAME: SwimUpdate
+ *
+ * DESCRIPTION: Membership change waiting to be piggybacked on SWIM messages
+ */
+typedef struct SwimUpdate {
+    int id;
+    short port;
+    long incarnation;
+    MemberState state;
+    // number of messages it was piggybacked on so far
+    size_t sent;
+} SwimUpdate;
+
+/**
+ * STRUCT NAME: PingReqRelay
+ *
+ * DESCRIPTION: PINGREQ this node is serving, the ACK of target goes to
+ * requester
+ */
+typedef struct PingReqRelay {
+    uint64_t target;
+    uint64_t requester;
+    long timestamp;
+} PingReqRelay;
+
+/**
+ * STRUCT NAME: LateProbe
+ *
+ * DESCRIPTION: SWIM probe whose period ended without an ack, the target
+ * becomes suspect at deadline unless an ack still turns up
+ */
+typedef struct LateProbe {
+    uint64_t target;
+    long deadline;
+} LateProbe;
+
+/**
+ * STRUCT NAME: DeadMember
+ *
+ * DESCRIPTION: tombstone of a removed member, the heartbeat (incarnation
+ * under SWIM) it was removed with and the time it was removed at
+ */
+typedef struct DeadMember {
+    long heartbeat;
+    long removedAt;
+} DeadMember;
+
 /**
  * CLASS NAME: MP1Node
  *
@@ -61,12 +163,61 @@ class MP1Node {
     Params *par;
     Member *memberNode;
     char NULLADDR[ADDR_LEN];
+    Random rng;
+    // permutation of memberList indices, partially reshuffled every gossip
+    vector<size_t> gossipOrder;
+    // packed (id, port) key -> slot in memberList
+    unordered_map<uint64_t, size_t> memberIndex;
+    // per slot in memberList, value of memberVersion when it last changed
+    vector<uint64_t> memberVersions;
+    uint64_t memberVersion;
+    // per slot in memberList, time the member became suspect, -1 if alive
+    vector<long> suspectSince;
+    // per slot in memberList, arrival history of its heartbeats
+    vector<PhiAccrual> detectors;
+    // packed key -> tombstone of a removed member, only a newer heartbeat
+    // brings it back. Dropped by expireDeadMembers once stale news of the
+    // member can no longer be around.
+    unordered_map<uint64_t, DeadMember> deadMembers;
+    // packed (id, port) key -> gossip state of that peer
+    unordered_map<uint64_t, GossipPeer> gossipPeers;
+    // packed key of a round's origin -> newest of its rounds forwarded
+    unordered_map<uint64_t, long> seenRounds;
+    // gossip messages still allowed for forwarding at relayTime
+    long relayTime;
+    int relayBudget;
+    // SWIM: current probe
+    uint64_t probeTarget;
+    long probeStart;
+    bool probeInProgress;
+    bool probeAcked;
+    bool pingReqSent;
+    // SWIM: next slot of gossipOrder to probe, reshuffled after a full pass
+    // or a removal
+    size_t probeIndex;
+    // SWIM: updates to disseminate
+    vector<SwimUpdate> swimUpdates;
+    vector<PingReqRelay> pingReqRelays;
+    vector<LateProbe> lateProbes;
+    // introducer: joins it handled that are still to be announced
+    vector<MemberListEntry> newJoins;
+    // introducer: joins announced by other introducers, to pass on
+    vector<MemberListEntry> relayedJoins;
+    // introducer: packed keys of the nodes it introduced
+    vector<uint64_t> introduced;
+    // Lifeguard local health multiplier, 0 when this node keeps up
+    int localHealth;
+    // time the oldest message waiting in mp1q arrived, -1 if empty
+    long queueSince;
 
    public:
     MP1Node(Member *, Params *, EmulNet *, Log *, Address *);
     Member *getMemberNode() { return memberNode; }
     int recvLoop();
     static int enqueueWrapper(void *env, char *buff, int size);
+    // MsgTypes of the messages on the membership EmulNet
+    static const TrafficClass trafficClass;
+    static int msgTypeOf(const char *data, int size);
     void nodeStart(char *servaddrstr, short serverport);
     int initThisNode(Address *joinaddr);
     int introduceSelfToGroup(Address *joinAddress);
@@ -75,33 +226,86 @@ class MP1Node {
     void checkMessages();
     bool recvCallBack(void *env, char *data, int size);
     void nodeLoopOps();
+    double suspicionLevel(int id, short port);
     int isNullAddress(Address *addr);
     static Address getJoinAddress();
+    Address getIntroducerAddress();
     void initMemberListTable(Member *memberNode);
     void printAddress(Address *addr) const;
     virtual ~MP1Node();
 
    private:
+    // times the member list codec below
+    friend class MP1NodeBench;
+
     void handleRecvJoinReq(Member *m, MessageHdr *msg, int msgSize);
     void handleRecvJoinRep(Member *m, MessageHdr *msg, int msgSize);
     void handleRecvGossipMsg(Member *m, MessageHdr *msg, int msgSize);
+    void handleRecvSyncReq(Member *m, MessageHdr *msg, int msgSize);
+    void handleRecvJoinAnn(Member *m, MessageHdr *msg, int msgSize);
+    void applyJoinedMembers(Member *m, vector<MemberListEntry> &joined);
+    void announceJoins();
+    void antiEntropy();
+    void handleRecvDigest(Member *m, MessageHdr *msg, int msgSize);
+    void handleRecvDigestRep(Member *m, MessageHdr *msg, int msgSize);
+    void computeDigest(size_t buckets, vector<uint32_t> &hashes);
+    bool isIntroducer(int id);
     void updateMemberList(Member *m, char *addr, int heartbeat, int timestamp);
-    void gossip(unordered_map<string, bool> &exclude, long timestamp);
+    MemberListEntry *findMember(int id, short port);
+    void addMember(const MemberListEntry &e);
+    void removeMember(size_t slot);
+    void touchMember(MemberListEntry *me);
+    long suspicionTimeout(long period);
+    void expireDeadMembers(long curTime, long period);
+    bool heartbeatOverdue(size_t slot, long curTime);
+    void adjustLocalHealth(int delta);
+    long healthScaled(long timeout);
+    bool isSlowNode();
+    int gossipFanout();
+    bool takeRound(char *origin, long round);
+    int gossip(const unordered_set<uint64_t> &exclude, char *origin,
+               long round, int fanout);
+    void syncGossipOrder();
+
+    // SWIM
+    void swimLoopOps();
+    bool nextProbeTarget(uint64_t &key);
+    void sendPingReqs();
+    void handleRecvSwimMsg(Member *m, MessageHdr *msg, int msgSize);
+    void applySwimUpdate(int id, short port, long incarnation,
+                         MemberState state, bool disseminate);
+    void queueSwimUpdate(int id, short port, long incarnation,
+                         MemberState state);
+    void collectSwimUpdates(vector<MemberListEntry> &alive,
+                            vector<MemberListEntry> &failed);
+    void sendSwimMsg(Address *addr, MsgTypes ms, Address *target);
+    void collectGossipEntries(uint64_t peer, vector<MemberListEntry> &entries);
 
     // util func
     static int getIdFromAddr(char *addr);
     static short getPortFromAddr(char *addr);
     static void loadAddr(Address *addr, int id, short port);
+    size_t frameBudget();
     void sendMsg(Address *addr, MsgTypes ms);
-    void sendMsg(Address *addr, MsgTypes ms, vector<MemberListEntry> &sent, long timestamp);
+    void sendMsg(Address *addr, MsgTypes ms, vector<MemberListEntry> &entries,
+                 vector<MemberListEntry> &sent, long timestamp,
+                 char *origin = NULL);
 
-    // unordered_map<string, int> memberListToHT(vector<MemberListEntry> &ml);
-    static string getIdAndPortString(int id, short port);
-    void loadIdAndPortFromString(string idAndPort, int &id, short &port);
+    static uint64_t getMemberKey(int id, short port);
+    static uint64_t mixHash(uint64_t x);
+    static void loadIdAndPortFromKey(uint64_t key, int &id, short &port);
 
     // serialize and deserialize
-    void marshall(char *_dest, vector<MemberListEntry> &m, vector<MemberListEntry> &sent);
-    void unmarshall(char *_src, size_t dataSize, size_t sentSize, vector<MemberListEntry> &m, vector<MemberListEntry> &sent);
+    void unmarshall(char *_src, size_t dataSize, size_t sentSize,
+                    vector<MemberListEntry> &m, vector<MemberListEntry> &sent);
+    static void sortEntries(vector<MemberListEntry> &m);
+    static size_t marshallEntries(char *_dest, vector<MemberListEntry> &m,
+                                  size_t &next, size_t limit);
+    void unmarshallEntries(char *_src, size_t size,
+                           vector<MemberListEntry> &m);
+    static uint8_t *putVarint(uint8_t *dest, uint64_t v);
+    static const uint8_t *getVarint(const uint8_t *src, const uint8_t *end,
+                                    uint64_t &v);
 };
 
 #endif /* _MP1NODE_H_ */
@@ -9,11 +9,12 @@
  * constructor
  */
 MP2Node::MP2Node(Member *memberNode, Params *par, EmulNet *emulNet, Log *log,
-                 Address *address) {
+                 Latency *latency, Address *address) {
     this->memberNode = memberNode;
     this->par = par;
     this->emulNet = emulNet;
     this->log = log;
+    this->latency = latency;
     ht = new HashTable();
     this->memberNode->addr = *address;
     selfNode = Node(*address);
@@ -145,6 +146,8 @@ void MP2Node::sendMsg(const string &&key, const string &&value,
     Message m(++g_transID, memberNode->addr, type, key, value);
     transactionTable.insert({g_transID, make_pair(m, vector<Message>{})});
     txToNodeTable[g_transID] = replicas;
+    txToStartTable[g_transID] = par->getcurrtime();
+    latency->start(type);
 
     for (int i = 0; i < replicas.size(); ++i) {
         sendWithReplicaType(forward<Address>(replicas[i].nodeAddress),
@@ -375,6 +378,19 @@ void MP2Node::logFail(Message &&msg) {
     }
 }
 
+/**
+ * FUNCTION NAME: recordLatency
+ *
+ * DESCRIPTION: record how long transaction transID took to reach or miss its
+ * 				quorum
+ */
+void MP2Node::recordLatency(int transID, MessageType type, bool success) {
+    auto iter = txToStartTable.find(transID);
+    if (iter == txToStartTable.end()) return;
+    latency->finish(type, par->getcurrtime() - iter->second, success);
+    txToStartTable.erase(iter);
+}
+
 /**
  * FUNCTION NAME: checkMessages
  *
@@ -484,14 +500,17 @@ void MP2Node::checkMessages() {
 
                     if (quorum >= 2) {
                         // success
+                        recordLatency(m.transID, iter->second.first.type, true);
+                        logSuccess(forward<Message>(iter->second.first));
                         transactionTable.erase(m.transID);
                         txToNodeTable.erase(m.transID);
-                        logSuccess(forward<Message>(iter->second.first));
                     } else if (iter->second.second.size() == 3) {
                         // fail
+                        recordLatency(m.transID, iter->second.first.type,
+                                      false);
+                        logFail(forward<Message>(iter->second.first));
                         transactionTable.erase(m.transID);
                         txToNodeTable.erase(m.transID);
-                        logFail(forward<Message>(iter->second.first));
                     }
                 }
                 break;
@@ -512,16 +531,18 @@ void MP2Node::checkMessages() {
 
                     if (quorum >= 2) {
                         // success
-                        transactionTable.erase(m.transID);
-                        txToNodeTable.erase(m.transID);
+                        recordLatency(m.transID, READ, true);
                         log->logReadSuccess(&memberNode->addr, true, m.transID,
                                             iter->second.first.key, m.value);
-                    } else if (iter->second.second.size() == 3) {
-                        // fail
                         transactionTable.erase(m.transID);
                         txToNodeTable.erase(m.transID);
+                    } else if (iter->second.second.size() == 3) {
+                        // fail
+                        recordLatency(m.transID, READ, false);
                         log->logReadFail(&memberNode->addr, true, m.transID,
                                          iter->second.first.key);
+                        transactionTable.erase(m.transID);
+                        txToNodeTable.erase(m.transID);
                     }
                 }
                 break;
@@ -566,11 +587,13 @@ void MP2Node::checkMessages() {
                     if (quorum >= 2) {
                         // success
                         txToRemove.push_back(txID);
+                        recordLatency(txID, READ, true);
                         log->logReadSuccess(&memberNode->addr, true, m.transID,
                                             m.key, value);
                     } else if (tx.second.second.size() == 3) {
                         // fail
                         txToRemove.push_back(txID);
+                        recordLatency(txID, READ, false);
                         log->logReadFail(&memberNode->addr, true, m.transID,
                                          m.key);
                     }
@@ -585,10 +608,12 @@ void MP2Node::checkMessages() {
                     if (quorum >= 2) {
                         // success
                         txToRemove.push_back(txID);
+                        recordLatency(txID, m.type, true);
                         logSuccess(forward<Message>(m));
                     } else if (tx.second.second.size() == 3) {
                         // fail
                         txToRemove.push_back(txID);
+                        recordLatency(txID, m.type, false);
                         logFail(forward<Message>(m));
                     }
                     break;
@@ -660,6 +685,39 @@ int MP2Node::enqueueWrapper(void *env, char *buff, int size) {
     return q.enqueue((queue<q_elt> *)env, (void *)buff, size);
 }
 
+// the types past READREPLY: CREATE and DELETE sent by stabilizationProtocol,
+// and what could not be parsed
+#define STABILIZE_TYPE (READREPLY + 1)
+#define OTHER_TYPE (READREPLY + 2)
+
+static const char *messageTypeNames[OTHER_TYPE + 1] = {
+    "CREATE", "READ", "UPDATE", "DELETE", "REPLY", "READREPLY", "STABILIZE",
+    "OTHER"};
+
+const TrafficClass MP2Node::trafficClass = {
+    "mp2", OTHER_TYPE + 1, messageTypeNames, msgTypeOf, EMULNET_KV_STREAM};
+
+/**
+ * FUNCTION NAME: msgTypeOf
+ *
+ * DESCRIPTION: MessageType of a message sent on the KV store EmulNet
+ * 				Messages are "transID::address::type::...", those of
+ * transaction -1 come from stabilizationProtocol.
+ */
+int MP2Node::msgTypeOf(const char *data, int size) {
+    char head[64];
+    int len = min(size, (int)sizeof(head) - 1);
+    memcpy(head, data, len);
+    head[len] = '\0';
+
+    char *addr = strstr(head, "::");
+    char *type = addr ? strstr(addr + 2, "::") : NULL;
+    if (type == NULL) return OTHER_TYPE;
+    if (atoi(head) == -1) return STABILIZE_TYPE;
+    int t = atoi(type + 2);
+    return t >= CREATE && t <= READREPLY ? t : OTHER_TYPE;
+}
+
 /**
  * FUNCTION NAME: ringToTable
  *
@@ -689,6 +747,7 @@ void MP2Node::stabilizationProtocol() {
     /*
      * Implement this
      */
+    TRACE_SCOPE("mp2.stabilizationProtocol", *(int *)memberNode->addr.addr);
     for (const auto &pair : ht->hashTable) {
         Entry e(pair.second);
         vector<Node> nodes = findNodes(pair.first);
@@ -15,6 +15,7 @@
 
 #include "EmulNet.h"
 #include "HashTable.h"
+#include "Latency.h"
 #include "Log.h"
 #include "Message.h"
 #include "Node.h"
@@ -51,6 +52,8 @@ class MP2Node {
     EmulNet *emulNet;
     // Object of Log
     Log *log;
+    // latency of the CRUD operations, shared by all nodes
+    Latency *latency;
 
     Node selfNode;
 
@@ -61,6 +64,7 @@ class MP2Node {
     void replyMsg(Message &&, string &&);
     void logSuccess(Message &&);
     void logFail(Message &&);
+    void recordLatency(int transID, MessageType type, bool success);
     void ringToTable();
 
     unordered_map<int, pair<Message, vector<Message>>> transactionTable;
@@ -68,10 +72,12 @@ class MP2Node {
     unordered_map<size_t, int> nodeTable;
 
     unordered_map<int, vector<Node>> txToNodeTable;
+    // time each transaction was sent at
+    unordered_map<int, int> txToStartTable;
 
    public:
     MP2Node(Member *memberNode, Params *par, EmulNet *emulNet, Log *log,
-            Address *addressOfMember);
+            Latency *latency, Address *addressOfMember);
     Member *getMemberNode() { return this->memberNode; }
 
     // ring functionalities
@@ -89,6 +95,9 @@ class MP2Node {
     // receive messages from Emulnet
     bool recvLoop();
     static int enqueueWrapper(void *env, char *buff, int size);
+    // MessageType of the messages on the KV store EmulNet, and stabilization
+    static const TrafficClass trafficClass;
+    static int msgTypeOf(const char *data, int size);
 
     // handle messages from receiving queue
     void checkMessages();
@@ -5,6 +5,7 @@
  **********************************/
 
 #include "Params.h"
+#include "Trace.h"
 
 /**
  * Constructor
@@ -15,45 +16,210 @@ Params::Params() : PORTNUM(8001) {}
  * FUNCTION NAME: setparams
  *
  * DESCRIPTION: Set the parameters for this test case
+ * 				The *.conf file is a list of "KEY: value" lines in
+ * any order. Keys that are not present keep their default value, so the
+ * original test cases (MAX_NNB and CRUD_TEST only) still work.
  */
 void Params::setparams(char *config_file) {
-    // trace.funcEntry("Params::setparams");
-    char CRUD[10];
-    FILE *fp = fopen(config_file, "r");
+    TRACE_SCOPE("Params::setparams", 0);
+    char line[MAX_CONF_LINE];
+    char name[MAX_CONF_LINE];
+    char value[MAX_CONF_LINE];
+
+    MAX_NNB = 10;
+    SINGLE_FAILURE = 0;
+    DROP_MSG = 0;
+    MSG_DROP_PROB = 0;
+    CRUDTEST = CREATE_TEST;
+    EN_GPSZ = -1;
+    TOTAL_RUNNING_TIME = DEFAULT_TOTAL_RUNNING_TIME;
+    INSERT_TIME = -1;
+    TEST_TIME = -1;
+    NUMBER_OF_INSERTS = DEFAULT_NUMBER_OF_INSERTS;
+    KEY_LENGTH = DEFAULT_KEY_LENGTH;
+    VALUE_LENGTH = DEFAULT_VALUE_LENGTH;
+    SEED = (unsigned int)time(NULL);
+    MAX_INFLIGHT_PER_NODE = 0;
+    MAX_MSG_SIZE = DEFAULT_MAX_MSG_SIZE;
+    MEMBERSHIP_PROTOCOL = GOSSIP_PROTOCOL;
+    FAIL_TIME = -1;
+    SUSPICION_MULT = DEFAULT_SUSPICION_MULT;
+    PHI_THRESHOLD = DEFAULT_PHI_THRESHOLD;
+    SLOW_NODES = 0;
+    SLOW_NODE_DELAY = 1;
+    INTRODUCERS = 1;
+    JOIN_ANNOUNCE_FANOUT = 0;
+    GOSSIP_FANOUT = 0;
+    GOSSIP_FANOUT_EXTRA = DEFAULT_GOSSIP_FANOUT_EXTRA;
+    ANTI_ENTROPY_INTERVAL = DEFAULT_ANTI_ENTROPY_INTERVAL;
+    BINARY_LOG = 0;
+    LOG_LEVEL = LOG_LEVEL_DEBUG;
+    LOG_CATEGORIES = LOG_ALL;
+    OPS_PER_TICK = 0;
+    READ_PERCENT = DEFAULT_READ_PERCENT;
 
-    fscanf(fp, "MAX_NNB: %d", &MAX_NNB);
-    fscanf(fp, "\nSINGLE_FAILURE: %d", &SINGLE_FAILURE);
-    fscanf(fp, "\nDROP_MSG: %d", &DROP_MSG);
-    fscanf(fp, "\nMSG_DROP_PROB: %lf", &MSG_DROP_PROB);
-    fscanf(fp, "\nCRUD_TEST: %s", CRUD);
+    FILE *fp = fopen(config_file, "r");
+    if (fp == NULL) {
+        cout << "Unable to open configuration file " << config_file << endl;
+        exit(1);
+    }
 
-    if (0 == strcmp(CRUD, "CREATE")) {
-        this->CRUDTEST = CREATE_TEST;
-    } else if (0 == strcmp(CRUD, "READ")) {
-        this->CRUDTEST = READ_TEST;
-    } else if (0 == strcmp(CRUD, "UPDATE")) {
-        this->CRUDTEST = UPDATE_TEST;
-    } else if (0 == strcmp(CRUD, "DELETE")) {
-        this->CRUDTEST = DELETE_TEST;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (sscanf(line, " %[^: ] : %s", name, value) == 2) {
+            setparam(name, value);
+        }
     }
+    fclose(fp);
 
     // printf("Parameters of the test case: %d %d %d %lf\n", MAX_NNB,
     // SINGLE_FAILURE, DROP_MSG, MSG_DROP_PROB);
 
-    EN_GPSZ = MAX_NNB;
     STEP_RATE = .25;
-    MAX_MSG_SIZE = 4000;
+
+    // the node count defaults to MAX_NNB, and the insert/test times keep
+    // their original offsets from the end of the run, but never fall before
+    // the KV store starts, 50 time units after the last node joined
+    if (EN_GPSZ <= 0) EN_GPSZ = MAX_NNB;
+    if (INSERT_TIME < 0) {
+        INSERT_TIME = max(TOTAL_RUNNING_TIME - 600,
+                          (int)(STEP_RATE * (EN_GPSZ - 1)) + 51);
+    }
+    if (TEST_TIME < 0) TEST_TIME = INSERT_TIME + 50;
     globaltime = 0;
     dropmsg = 0;
     allNodesJoined = 0;
-    for (unsigned int i = 0; i < EN_GPSZ; i++) {
+    for (int i = 0; i < EN_GPSZ; i++) {
         allNodesJoined += i;
     }
-    fclose(fp);
-    // trace.funcExit("Params::setparams", SUCCESS);
     return;
 }
 
+/**
+ * FUNCTION NAME: setparam
+ *
+ * DESCRIPTION: Set a single parameter read from the *.conf file
+ */
+void Params::setparam(const char *name, const char *value) {
+    if (0 == strcmp(name, "MAX_NNB")) {
+        MAX_NNB = atoi(value);
+    } else if (0 == strcmp(name, "SINGLE_FAILURE")) {
+        SINGLE_FAILURE = atoi(value);
+    } else if (0 == strcmp(name, "DROP_MSG")) {
+        DROP_MSG = atoi(value);
+    } else if (0 == strcmp(name, "MSG_DROP_PROB")) {
+        MSG_DROP_PROB = atof(value);
+    } else if (0 == strcmp(name, "CRUD_TEST")) {
+        if (0 == strcmp(value, "CREATE")) {
+            this->CRUDTEST = CREATE_TEST;
+        } else if (0 == strcmp(value, "READ")) {
+            this->CRUDTEST = READ_TEST;
+        } else if (0 == strcmp(value, "UPDATE")) {
+            this->CRUDTEST = UPDATE_TEST;
+        } else if (0 == strcmp(value, "DELETE")) {
+            this->CRUDTEST = DELETE_TEST;
+        }
+    } else if (0 == strcmp(name, "NODE_COUNT")) {
+        EN_GPSZ = atoi(value);
+    } else if (0 == strcmp(name, "TOTAL_RUNNING_TIME")) {
+        TOTAL_RUNNING_TIME = atoi(value);
+    } else if (0 == strcmp(name, "INSERT_TIME")) {
+        INSERT_TIME = atoi(value);
+    } else if (0 == strcmp(name, "TEST_TIME")) {
+        TEST_TIME = atoi(value);
+    } else if (0 == strcmp(name, "NUMBER_OF_INSERTS")) {
+        NUMBER_OF_INSERTS = atoi(value);
+    } else if (0 == strcmp(name, "KEY_LENGTH")) {
+        KEY_LENGTH = atoi(value);
+    } else if (0 == strcmp(name, "VALUE_LENGTH")) {
+        VALUE_LENGTH = atoi(value);
+    } else if (0 == strcmp(name, "SEED")) {
+        SEED = (unsigned int)strtoul(value, NULL, 10);
+    } else if (0 == strcmp(name, "MAX_INFLIGHT_PER_NODE")) {
+        MAX_INFLIGHT_PER_NODE = atoi(value);
+    } else if (0 == strcmp(name, "MAX_MSG_SIZE")) {
+        MAX_MSG_SIZE = atoi(value);
+    } else if (0 == strcmp(name, "MEMBERSHIP_PROTOCOL")) {
+        if (0 == strcmp(value, "GOSSIP")) {
+            MEMBERSHIP_PROTOCOL = GOSSIP_PROTOCOL;
+        } else if (0 == strcmp(value, "SWIM")) {
+            MEMBERSHIP_PROTOCOL = SWIM_PROTOCOL;
+        }
+    } else if (0 == strcmp(name, "FAIL_TIME")) {
+        FAIL_TIME = atoi(value);
+    } else if (0 == strcmp(name, "SUSPICION_MULT")) {
+        SUSPICION_MULT = atoi(value);
+    } else if (0 == strcmp(name, "PHI_THRESHOLD")) {
+        PHI_THRESHOLD = atof(value);
+    } else if (0 == strcmp(name, "SLOW_NODES")) {
+        SLOW_NODES = atoi(value);
+    } else if (0 == strcmp(name, "SLOW_NODE_DELAY")) {
+        SLOW_NODE_DELAY = atoi(value);
+    } else if (0 == strcmp(name, "INTRODUCERS")) {
+        INTRODUCERS = atoi(value);
+    } else if (0 == strcmp(name, "JOIN_ANNOUNCE_FANOUT")) {
+        JOIN_ANNOUNCE_FANOUT = atoi(value);
+    } else if (0 == strcmp(name, "GOSSIP_FANOUT")) {
+        GOSSIP_FANOUT = atoi(value);
+    } else if (0 == strcmp(name, "GOSSIP_FANOUT_EXTRA")) {
+        GOSSIP_FANOUT_EXTRA = atoi(value);
+    } else if (0 == strcmp(name, "ANTI_ENTROPY_INTERVAL")) {
+        ANTI_ENTROPY_INTERVAL = atoi(value);
+    } else if (0 == strcmp(name, "BINARY_LOG")) {
+        BINARY_LOG = atoi(value);
+    } else if (0 == strcmp(name, "LOG_LEVEL")) {
+        if (0 == strcmp(value, "DEBUG")) {
+            LOG_LEVEL = LOG_LEVEL_DEBUG;
+        } else if (0 == strcmp(value, "INFO")) {
+            LOG_LEVEL = LOG_LEVEL_INFO;
+        } else if (0 == strcmp(value, "WARN")) {
+            LOG_LEVEL = LOG_LEVEL_WARN;
+        } else if (0 == strcmp(value, "ERROR")) {
+            LOG_LEVEL = LOG_LEVEL_ERROR;
+        } else if (0 == strcmp(value, "OFF")) {
+            LOG_LEVEL = LOG_LEVEL_OFF;
+        }
+    } else if (0 == strcmp(name, "LOG_CATEGORIES")) {
+        LOG_CATEGORIES = parseCategories(value);
+    } else if (0 == strcmp(name, "OPS_PER_TICK")) {
+        OPS_PER_TICK = atoi(value);
+    } else if (0 == strcmp(name, "READ_PERCENT")) {
+        READ_PERCENT = atoi(value);
+    } else {
+        cout << "Unknown configuration key " << name << endl;
+    }
+}
+
+/**
+ * FUNCTION NAME: parseCategories
+ *
+ * DESCRIPTION: Parse the value of LOG_CATEGORIES into a mask of logCATEGORY
+ * 				The value is a comma separated list of APP, MEMBERSHIP,
+ * KVSTORE, NET and ALL.
+ */
+int Params::parseCategories(const char *value) {
+    char list[MAX_CONF_LINE];
+    int mask = 0;
+
+    strncpy(list, value, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+    for (char *c = strtok(list, ","); c != NULL; c = strtok(NULL, ",")) {
+        if (0 == strcmp(c, "APP")) {
+            mask |= LOG_APP;
+        } else if (0 == strcmp(c, "MEMBERSHIP")) {
+            mask |= LOG_MEMBERSHIP;
+        } else if (0 == strcmp(c, "KVSTORE")) {
+            mask |= LOG_KVSTORE;
+        } else if (0 == strcmp(c, "NET")) {
+            mask |= LOG_NET;
+        } else if (0 == strcmp(c, "ALL")) {
+            mask |= LOG_ALL;
+        } else {
+            cout << "Unknown log category " << c << endl;
+        }
+    }
+    return mask;
+}
+
 /**
  * FUNCTION NAME: getcurrtime
  *
@@ -11,7 +11,40 @@
 #include "Params.h"
 #include "stdincludes.h"
 
+/*
+ * Macros
+ */
+// defaults used when a key is missing from the *.conf file
+#define DEFAULT_TOTAL_RUNNING_TIME 700
+#define DEFAULT_NUMBER_OF_INSERTS 100
+#define DEFAULT_KEY_LENGTH 5
+#define DEFAULT_VALUE_LENGTH 0
+#define DEFAULT_MAX_MSG_SIZE 4000
+#define DEFAULT_SUSPICION_MULT 4
+#define DEFAULT_PHI_THRESHOLD 8
+#define DEFAULT_GOSSIP_FANOUT_EXTRA 2
+#define DEFAULT_ANTI_ENTROPY_INTERVAL 10
+#define DEFAULT_READ_PERCENT 50
+#define MAX_CONF_LINE 256
+
 enum testTYPE { CREATE_TEST, READ_TEST, UPDATE_TEST, DELETE_TEST };
+enum membershipTYPE { GOSSIP_PROTOCOL, SWIM_PROTOCOL };
+// severity of a log line, a line is written when at or above LOG_LEVEL
+enum logLEVEL {
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_OFF
+};
+// subsystem of a log line, LOG_CATEGORIES is a mask of these
+enum logCATEGORY {
+    LOG_APP = 1,
+    LOG_MEMBERSHIP = 2,
+    LOG_KVSTORE = 4,
+    LOG_NET = 8,
+    LOG_ALL = 15
+};
 
 /**
  * CLASS NAME: Params
@@ -32,9 +65,37 @@ class Params {
     int allNodesJoined;
     short PORTNUM;
     int CRUDTEST;
+    int TOTAL_RUNNING_TIME;  // number of simulated time units
+    int INSERT_TIME;         // time at which the test KV pairs are inserted
+    int TEST_TIME;           // time at which the CRUD test starts
+    int NUMBER_OF_INSERTS;   // number of test KV pairs
+    int KEY_LENGTH;          // length of a test key
+    int VALUE_LENGTH;        // length of a test value, 0 for "value<n>"
+    unsigned int SEED;       // seed of the random number generator
+    int MAX_INFLIGHT_PER_NODE;  // messages queued per receiver, 0 = no limit
+    int MEMBERSHIP_PROTOCOL;    // GOSSIP_PROTOCOL or SWIM_PROTOCOL
+    int FAIL_TIME;              // time at which fail() fails nodes, -1 = never
+    int SUSPICION_MULT;         // suspicion timeout in log10(n) failure periods
+    double PHI_THRESHOLD;       // phi at which a member turns suspect, 0 = TFAIL
+    int SLOW_NODES;             // last nodes that read their messages late
+    int SLOW_NODE_DELAY;        // a slow node reads messages every this often
+    int INTRODUCERS;            // nodes 1..INTRODUCERS answer join requests
+    int JOIN_ANNOUNCE_FANOUT;   // introduced nodes told of joins, 0 = off
+    int GOSSIP_FANOUT;          // gossip targets per round, 0 = log2(n) + extra
+    int GOSSIP_FANOUT_EXTRA;    // the extra in the logarithmic fanout
+    int ANTI_ENTROPY_INTERVAL;  // time between push-pull exchanges, 0 = off
+    int BINARY_LOG;             // log to dbg.bin instead of dbg.log
+    int LOG_LEVEL;              // least severe logLEVEL written
+    int LOG_CATEGORIES;         // mask of the logCATEGORY written
+    int OPS_PER_TICK;           // workload operations per time unit, 0 = off
+    int READ_PERCENT;           // share of the workload that reads
     Params();
     void setparams(char *);
     int getcurrtime();
+
+   private:
+    void setparam(const char *name, const char *value);
+    int parseCategories(const char *value);
 };
 
 #endif /* _PARAMS_H_ */
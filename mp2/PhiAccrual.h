@@ -0,0 +1,78 @@
+/**********************************
+ * FILE NAME: PhiAccrual.h
+ *
+ * DESCRIPTION: Header file for the phi accrual failure detector
+ **********************************/
+
+#ifndef PHIACCRUAL_H_
+#define PHIACCRUAL_H_
+
+#include "stdincludes.h"
+
+/**
+ * Macros
+ */
+// heartbeat inter-arrival times kept per member
+#define PHI_WINDOW_SIZE 32
+// inter-arrival times needed before phi is trusted
+#define PHI_MIN_SAMPLES 4
+// floor on the standard deviation, so a perfectly regular member does not
+// turn suspect the moment a single heartbeat is late
+#define PHI_MIN_STDDEV 0.5
+
+/**
+ * CLASS NAME: PhiAccrual
+ *
+ * DESCRIPTION: Phi accrual failure detector (Hayashibara et al.) for one
+ * member. Inter-arrival times of its heartbeats are kept in a ring buffer,
+ * and phi is -log10 of the probability that a heartbeat is still to come
+ * after this long, assuming normally distributed inter-arrival times. A
+ * phi of 1 means a 10% chance of a false suspicion, 2 means 1%, and so on.
+ */
+class PhiAccrual {
+   private:
+    long intervals[PHI_WINDOW_SIZE];
+    size_t count;
+    size_t next;
+    // running sums over the window, kept exact by staying integral
+    long sum;
+    long sumSq;
+    long last;
+
+   public:
+    PhiAccrual() : count(0), next(0), sum(0), sumSq(0), last(-1) {}
+    // record a heartbeat seen at time now
+    void heartbeat(long now) {
+        if (last >= 0 && now > last) {
+            long interval = now - last;
+            if (count == PHI_WINDOW_SIZE) {
+                sum -= intervals[next];
+                sumSq -= intervals[next] * intervals[next];
+            } else {
+                count++;
+            }
+            intervals[next] = interval;
+            next = (next + 1) % PHI_WINDOW_SIZE;
+            sum += interval;
+            sumSq += interval * interval;
+        }
+        if (now > last) last = now;
+    }
+    bool ready() const { return count >= PHI_MIN_SAMPLES; }
+    // suspicion level at time now, 0 until the window has PHI_MIN_SAMPLES
+    double phi(long now) const {
+        if (!ready()) return 0;
+
+        double mean = (double)sum / count;
+        double variance = (double)sumSq / count - mean * mean;
+        double stddev = max(PHI_MIN_STDDEV, sqrt(max(0.0, variance)));
+
+        // logistic approximation of the normal CDF, as used by Akka
+        double y = (now - last - mean) / stddev;
+        double e = exp(-y * (1.5976 + 0.070566 * y * y));
+        if (now - last > mean) return -log10(e / (1.0 + e));
+        return -log10(1.0 - 1.0 / (1.0 + e));
+    }
+};
+
+#endif /* PHIACCRUAL_H_ */
@@ -0,0 +1,73 @@
+/**********************************
+ * FILE NAME: Profiler.cpp
+ *
+ * DESCRIPTION: Profiler class definition
+ **********************************/
+
+#include "Profiler.h"
+
+static const char *phaseNames[DUMMYLASTPHASE] = {
+    "mp1.recvLoop",      "mp1.nodeLoop", "mp2.updateRing", "mp2.recvLoop",
+    "mp2.checkMessages", "en.ENsend",    "en.ENrecv"};
+
+/**
+ * Constructor
+ */
+Profiler::Profiler(int nodes) : nodes(nodes) {
+    started = chrono::steady_clock::now();
+    for (int p = 0; p < DUMMYLASTPHASE; p++) {
+        nanos[p].assign(nodes, 0);
+        calls[p].assign(nodes, 0);
+    }
+}
+
+/**
+ * FUNCTION NAME: dump
+ *
+ * DESCRIPTION: write the time of every phase to path
+ * 				The first table sums each phase over all nodes, with
+ * its share of the whole run and the node that spent the most in it. The
+ * second gives each node's milliseconds per phase.
+ */
+void Profiler::dump(const char *path) {
+    FILE *file = fopen(path, "w+");
+    if (file == NULL) return;
+
+    double runNs = chrono::duration_cast<chrono::nanoseconds>(
+                       chrono::steady_clock::now() - started)
+                       .count();
+
+    fprintf(file, "run %.1f ms\n\n", runNs / 1e6);
+    fprintf(file, "%-18s %9s %10s %6s %9s %9s %9s %6s %10s\n", "phase", "calls",
+            "total ms", "share", "mean ns", "p99 ns", "max ns", "node",
+            "node ms");
+    for (int p = 0; p < DUMMYLASTPHASE; p++) {
+        long long total = 0;
+        int slowest = 0;
+        for (int n = 0; n < nodes; n++) {
+            total += nanos[p][n];
+            if (nanos[p][n] > nanos[p][slowest]) slowest = n;
+        }
+        fprintf(file,
+                "%-18s %9llu %10.1f %5.1f%% %9.0f %9lld %9lld %6d %10.1f\n",
+                phaseNames[p], (unsigned long long)perCall[p].count(),
+                total / 1e6, runNs > 0 ? 100 * total / runNs : 0,
+                perCall[p].mean(), perCall[p].percentile(99),
+                perCall[p].max(), slowest + 1, nanos[p][slowest] / 1e6);
+    }
+
+    fprintf(file, "\n%-6s", "node");
+    for (int p = 0; p < DUMMYLASTPHASE; p++) {
+        fprintf(file, " %17s", phaseNames[p]);
+    }
+    fprintf(file, "\n");
+    for (int n = 0; n < nodes; n++) {
+        fprintf(file, "%-6d", n + 1);
+        for (int p = 0; p < DUMMYLASTPHASE; p++) {
+            fprintf(file, " %17.3f", nanos[p][n] / 1e6);
+        }
+        fprintf(file, "\n");
+    }
+
+    fclose(file);
+}
@@ -0,0 +1,106 @@
+/**********************************
+ * FILE NAME: Profiler.h
+ *
+ * DESCRIPTION: Header file of Profiler class
+ **********************************/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <chrono>
+
+#include "Histogram.h"
+#include "stdincludes.h"
+
+/*
+ * Macros
+ */
+#define PROFILE_LOG "profile.log"
+
+/**
+ * Phases of a simulated time unit that are timed
+ */
+enum profilePHASE {
+    PHASE_MP1_RECV,
+    PHASE_MP1_NODELOOP,
+    PHASE_MP2_UPDATERING,
+    PHASE_MP2_RECV,
+    PHASE_MP2_CHECK,
+    // EmulNet time is also counted in the phase that called into it
+    PHASE_EN_SEND,
+    PHASE_EN_RECV,
+    DUMMYLASTPHASE
+};
+
+/**
+ * CLASS NAME: Profiler
+ *
+ * DESCRIPTION: Wall-clock time spent in each phase, per node
+ * 				Every timed call adds its duration to the total of its
+ * phase and node and to a histogram of the phase, which dump() summarizes
+ * in profile.log.
+ */
+class Profiler {
+   private:
+    int nodes;
+    chrono::steady_clock::time_point started;
+    // per phase, per node nanoseconds and calls
+    vector<long long> nanos[DUMMYLASTPHASE];
+    vector<long> calls[DUMMYLASTPHASE];
+    // per phase nanoseconds of each call
+    Histogram perCall[DUMMYLASTPHASE];
+
+   public:
+    Profiler(int nodes);
+    void add(int phase, int node, long long ns) {
+        if (node >= 0 && node < nodes) {
+            nanos[phase][node] += ns;
+            calls[phase][node]++;
+        }
+        perCall[phase].record(ns);
+    }
+    void dump(const char *path);
+};
+
+/**
+ * CLASS NAME: ScopedTimer
+ *
+ * DESCRIPTION: Times its own lifetime into a Profiler, or does nothing when
+ * 				the profiler is NULL
+ * 				Built with make PROFILEFLAGS=-DPROFILE_DISABLED it does
+ * nothing at all and reads no clock, so profile.log only lists phases without
+ * calls.
+ */
+#ifdef PROFILE_DISABLED
+class ScopedTimer {
+   public:
+    ScopedTimer(Profiler *profiler, int phase, int node) {}
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+};
+#else
+class ScopedTimer {
+   private:
+    Profiler *profiler;
+    int phase;
+    int node;
+    chrono::steady_clock::time_point start;
+
+   public:
+    ScopedTimer(Profiler *profiler, int phase, int node)
+        : profiler(profiler), phase(phase), node(node) {
+        if (profiler) start = chrono::steady_clock::now();
+    }
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+    ~ScopedTimer() {
+        if (!profiler) return;
+        auto elapsed = chrono::steady_clock::now() - start;
+        profiler->add(
+            phase, node,
+            chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+    }
+};
+#endif
+
+#endif /* PROFILER_H_ */
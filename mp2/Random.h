@@ -0,0 +1,81 @@
+/**********************************
+ * FILE NAME: Random.h
+ *
+ * DESCRIPTION: Header file for the seeded pseudo random number generator
+ **********************************/
+
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <stdint.h>
+
+#include "stdincludes.h"
+
+/**
+ * Independent streams drawn from the same seed. The EmulNet of each layer
+ * has its own, so drops on one layer say nothing about drops on the other.
+ */
+enum RandomStream {
+    APPLICATION_STREAM,
+    EMULNET_STREAM,
+    GOSSIP_STREAM,
+    EMULNET_KV_STREAM
+};
+
+/**
+ * CLASS NAME: Random
+ *
+ * DESCRIPTION: xoshiro256** generator. Every (seed, stream, id) triple gets
+ * its own sequence, so each node draws from a private stream and a run is
+ * reproducible from Params::SEED alone. Satisfies UniformRandomBitGenerator,
+ * so it can be handed to std::shuffle.
+ */
+class Random {
+   private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    static uint64_t splitmix64(uint64_t &x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+   public:
+    typedef uint64_t result_type;
+
+    Random() { seed(0, APPLICATION_STREAM, 0); }
+    Random(uint64_t seed, RandomStream stream, uint64_t id) {
+        this->seed(seed, stream, id);
+    }
+    void seed(uint64_t seed, RandomStream stream, uint64_t id) {
+        uint64_t x = seed;
+        x = splitmix64(x) ^ ((uint64_t)stream << 32) ^ id;
+        for (int i = 0; i < 4; i++) {
+            s[i] = splitmix64(x);
+        }
+    }
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+    // uniform integer in [0, bound)
+    uint32_t nextInt(uint32_t bound) {
+        return (uint32_t)(((next() >> 32) * (uint64_t)bound) >> 32);
+    }
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    result_type operator()() { return next(); }
+};
+
+#endif /* RANDOM_H_ */
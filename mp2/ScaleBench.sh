@@ -0,0 +1,73 @@
+#!/bin/bash
+
+#################################################
+# FILE NAME: ScaleBench.sh
+#
+# DESCRIPTION: Cost of a full run against group size and number of keys
+#
+# RUN PROCEDURE:
+# $ chmod +x ScaleBench.sh
+# $ ./ScaleBench.sh
+#
+# Runs every node count of NODES against every insert count of INSERTS. Each
+# run inserts the keys once every node has joined, then for WORKLOAD_TIME time
+# units issues OPS_PER_TICK operations per time unit on random keys,
+# READ_PERCENT percent of them reads and the rest updates, and reports the
+# wall-clock time per time unit, the peak RSS, the messages of both layers per
+# time unit and the operations that reached or missed their quorum per second
+# since the insert. The default grid goes up to 10000 nodes and 1000000 keys,
+# which takes hours, so pick a smaller one for a quick look, e.g.
+# NODES="10 100" INSERTS="100 10000" READ_PERCENT=90 ./ScaleBench.sh
+# SEED, PROTOCOL (GOSSIP or SWIM) and LOG_LEVEL can be set in the environment.
+#################################################
+
+NODES=${NODES:-10 100 1000 10000}
+INSERTS=${INSERTS:-100 1000 10000 100000 1000000}
+OPS_PER_TICK=${OPS_PER_TICK:-100}
+READ_PERCENT=${READ_PERCENT:-50}
+WORKLOAD_TIME=${WORKLOAD_TIME:-100}
+SEED=${SEED:-1}
+PROTOCOL=${PROTOCOL:-GOSSIP}
+LOG_LEVEL=${LOG_LEVEL:-WARN}
+CONF=$(mktemp)
+
+make > /dev/null 2>&1
+if [ $? -ne 0 ]
+then
+    echo "COMPILATION ERROR !!!"
+    exit 1
+fi
+
+printf "%8s %9s %6s %12s %12s %12s %12s %10s\n" "NODES" "INSERTS" "TICKS" \
+    "US/TICK" "PEAK_RSS(KB)" "MSGS/TICK" "OPS/SEC" "WALL(s)"
+for n in ${NODES}
+do
+    # the last node joins at n / 4, the ring settles 50 time units later
+    insert_time=$((n / 4 + 60))
+    test_time=$((insert_time + 50))
+    for k in ${INSERTS}
+    do
+        cat > "${CONF}" <<EOF
+NODE_COUNT: ${n}
+NUMBER_OF_INSERTS: ${k}
+INSERT_TIME: ${insert_time}
+TEST_TIME: ${test_time}
+TOTAL_RUNNING_TIME: $((test_time + WORKLOAD_TIME))
+OPS_PER_TICK: ${OPS_PER_TICK}
+READ_PERCENT: ${READ_PERCENT}
+SEED: ${SEED}
+MEMBERSHIP_PROTOCOL: ${PROTOCOL}
+LOG_LEVEL: ${LOG_LEVEL}
+EOF
+        summary=$(./Application "${CONF}" | grep "Run summary")
+        field() {
+            echo "${summary}" | awk -v key="$1" \
+                '{ for (i = 1; i < NF; i++) if ($i == key) print $(i + 1) }'
+        }
+        printf "%8s %9s %6s %12s %12s %12s %12s %10s\n" "${n}" "${k}" \
+            "$(field ticks)" "$(field us_per_tick)" "$(field peak_rss_kb)" \
+            "$(field msgs_per_tick)" "$(field ops_per_sec)" "$(field wall_s)"
+    done
+done
+
+rm -f "${CONF}"
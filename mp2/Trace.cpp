@@ -17,112 +17,141 @@
  */
 #include "Trace.h"
 
+// bytes of JSON formatted before they are handed to the writer
+#define TRACE_CHUNK_SIZE (64 * 1024)
+// longest formatted event
+#define TRACE_EVENT_SIZE 256
+
+unique_ptr<LogWriter> Trace::writer;
+atomic<bool> Trace::tracing(false);
+chrono::steady_clock::time_point Trace::epoch = chrono::steady_clock::now();
+
 /*****************************************************************
- * NAME: traceFileCreate
- *
- * DESCRIPTION: Function creates a trace file
- *
- * RETURN:
- * (int) SUCCESS
- *       ERROR otherwise
+ * NAME: TraceBuffer
  *
+ * DESCRIPTION: Events of one thread, flushed when full and when the
+ *              thread exits
  ****************************************************************/
-int Trace::traceFileCreate() {
-    int rc = SUCCESS;  // Return code
+struct TraceBuffer {
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+    int count;
+    TraceBuffer() : count(0) {}
+    ~TraceBuffer() { Trace::flush(); }
+};
 
-    logF = fopen(LOG_FILE_LOCATION, "w");
-    if (NULL == logF) {
-        printf("\nUnable to open log file in write mode\n");
-        rc = FAILURE;
-    }
-
-    return rc;
-}
+static thread_local TraceBuffer buffer;
 
 /*****************************************************************
- * NAME: printToTrace
- *
- * DESCRIPTION: Function takes care of writing into log
+ * NAME: open
  *
- * PARAMETERS:
- *            (char *) keyMsg - buffer to be written as key
- *            (char *) valueMsg - buffer to be written as value
- *
- * RETURN:
- * (int) SUCCESS
- *       FAILURE otherwise
+ * DESCRIPTION: Starts tracing to path, later events are recorded
  *
  ****************************************************************/
-int Trace::printToTrace(char *keyMsg, char *valueMsg) {
-    int rc = SUCCESS;  // Return code
-
-    fprintf(logF, "%s : %s\n", keyMsg, valueMsg);
-    fflush(logF);
+void Trace::open(const char *path) {
+    if (tracing.load()) return;
 
-    return rc;
+    writer.reset(new LogWriter(path));
+    writer->append("[\n", 2);
+    epoch = chrono::steady_clock::now();
+    tracing.store(true);
 }
 
 /*****************************************************************
- * NAME: traceFileClose
+ * NAME: close
  *
- * DESCRIPTION: Function takes care of closing log
- *
- * RETURN:
- * (int) SUCCESS
- *       ERROR otherwise
+ * DESCRIPTION: Stops tracing, writes out the calling thread's events
+ *              and ends the JSON array
  *
  ****************************************************************/
-int Trace::traceFileClose() {
-    int rc = SUCCESS;
-
-    fclose(logF);
-
-    return rc;
+void Trace::close() {
+    if (!tracing.load()) return;
+
+    flush();
+    tracing.store(false);
+
+    // ends the array, every event before it is followed by a comma
+    const char *last =
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+        "\"args\":{\"name\":\"Application\"}}\n]\n";
+    writer->append(last, strlen(last));
+    writer->close();
 }
 
 /*****************************************************************
- * NAME: funcEntry
- *
- * DESCRIPTION: Logs function entry
- *
- * PARAMETERS:
- *            (char *) keyMsg - ipAddress
- *            (char *) valueMsg - funcName
+ * NAME: flush
  *
- * RETURN:
- * (int) ZERO if success
- *       ERROR otherwise
+ * DESCRIPTION: Formats the calling thread's events as JSON and hands
+ *              them to the writer
  *
  ****************************************************************/
-int Trace::funcEntry(char *funcName) {
-    int rc = SUCCESS;  // Return code
+void Trace::flush() {
+    static thread_local char chunk[TRACE_CHUNK_SIZE];
+    size_t len = 0;
 
-    fprintf(logF, "ENTRY - %s\n", funcName);
-    fflush(logF);
+    if (!tracing.load(memory_order_acquire)) {
+        buffer.count = 0;
+        return;
+    }
 
-    return rc;
+    for (int i = 0; i < buffer.count; i++) {
+        const TraceEvent &e = buffer.events[i];
+        char *out = chunk + len;
+        int n;
+
+        switch (e.phase) {
+            case 'X':
+                n = snprintf(out, TRACE_EVENT_SIZE,
+                             "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,"
+                             "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},\n",
+                             e.name, e.lane, e.ts / 1e3, e.arg / 1e3);
+                break;
+            case 'C':
+                n = snprintf(out, TRACE_EVENT_SIZE,
+                             "{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,"
+                             "\"tid\":%d,\"ts\":%.3f,"
+                             "\"args\":{\"value\":%lld}},\n",
+                             e.name, e.lane, e.ts / 1e3, e.arg);
+                break;
+            default:
+                n = snprintf(out, TRACE_EVENT_SIZE,
+                             "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\","
+                             "\"pid\":1,\"tid\":%d,\"ts\":%.3f},\n",
+                             e.name, e.lane, e.ts / 1e3);
+                break;
+        }
+        len += min(n, TRACE_EVENT_SIZE - 1);
+
+        if (len + TRACE_EVENT_SIZE > TRACE_CHUNK_SIZE) {
+            writer->append(chunk, len);
+            len = 0;
+        }
+    }
+    writer->append(chunk, len);
+    buffer.count = 0;
 }
 
 /*****************************************************************
- * NAME: funcExit
+ * NAME: record
  *
- * DESCRIPTION: Logs function exit
+ * DESCRIPTION: Buffers an event of the calling thread
  *
  * PARAMETERS:
- *            (char *) keyMsg - ipAddress
- *            (char *) valueMsg - funcName
- *            (int) f_rc - return code of function
- *
- * RETURN:
- * (int) ZERO if success
- *       ERROR otherwise
+ *            (const char *) name - string literal naming the event
+ *            (char) phase - 'X' slice, 'C' counter, 'i' instant
+ *            (int) lane - timeline row, the node id
+ *            (long long) ts - nanoseconds since open
+ *            (long long) arg - duration of a slice, value of a counter
  *
  ****************************************************************/
-int Trace::funcExit(char *funcName, int f_rc) {
-    int rc = SUCCESS;  // Return code
-
-    fprintf(logF, "EXIT - %s with rc = %d\n", funcName, f_rc);
-    fflush(logF);
-
-    return rc;
+void Trace::record(const char *name, char phase, int lane, long long ts,
+                   long long arg) {
+    if (!on()) return;
+
+    TraceEvent &e = buffer.events[buffer.count++];
+    e.name = name;
+    e.phase = phase;
+    e.lane = lane;
+    e.ts = ts;
+    e.arg = arg;
+    if (buffer.count == TRACE_BUFFER_EVENTS) flush();
 }
@@ -7,32 +7,111 @@
 #ifndef TRACE_H_
 #define TRACE_H_
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "LogWriter.h"
 #include "stdincludes.h"
 
 /*
  * Macros
  */
-#define LOG_FILE_LOCATION "machine.log"
+#define TRACE_FILE "trace.json"
+// events a thread buffers before it formats them for the file
+#define TRACE_BUFFER_EVENTS 4096
+
+/*
+ * Tracing macros, they compile to nothing unless built with
+ * make TRACEFLAGS=-DTRACE_ENABLED. Names must be string literals, a lane is
+ * a row of the timeline, the id of the node the event belongs to.
+ */
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#ifdef TRACE_ENABLED
+#define TRACE_OPEN(path) Trace::open(path)
+#define TRACE_CLOSE() Trace::close()
+// a slice from here to the end of the enclosing block
+#define TRACE_SCOPE(name, lane) \
+    TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, lane)
+#define TRACE_INSTANT(name, lane) \
+    Trace::record(name, 'i', lane, Trace::now(), 0)
+#define TRACE_COUNTER(name, value) \
+    Trace::record(name, 'C', 0, Trace::now(), value)
+#else
+#define TRACE_OPEN(path) ((void)0)
+#define TRACE_CLOSE() ((void)0)
+#define TRACE_SCOPE(name, lane) ((void)0)
+#define TRACE_INSTANT(name, lane) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#endif
+
+/**
+ * STRUCT NAME: TraceEvent
+ *
+ * DESCRIPTION: One buffered event, in nanoseconds since Trace::open
+ */
+typedef struct TraceEvent {
+    const char *name;
+    char phase;
+    int lane;
+    long long ts;
+    // duration of a slice, value of a counter
+    long long arg;
+} TraceEvent;
 
 /**
  * CLASS NAME: Trace
  *
- * DESCRIPTION: Creates a trace of function entry, exit and variable values for
- * debugging
+ * DESCRIPTION: Timeline of the run in the Chrome trace event format, which
+ * 				chrome://tracing and ui.perfetto.dev open
+ * 				Each thread records into its own buffer without taking a
+ * lock, and formats a full buffer as JSON for a LogWriter, which writes it
+ * out from the background. A thread flushes what is left when it exits, and
+ * close() flushes the calling thread, so threads that trace must be joined
+ * before it.
  */
 class Trace {
+   private:
+    static unique_ptr<LogWriter> writer;
+    static atomic<bool> tracing;
+    static chrono::steady_clock::time_point epoch;
+
+   public:
+    static void open(const char *path);
+    static void close();
+    static void flush();
+    static bool on() { return tracing.load(memory_order_relaxed); }
+    static long long now() {
+        return chrono::duration_cast<chrono::nanoseconds>(
+                   chrono::steady_clock::now() - epoch)
+            .count();
+    }
+    static void record(const char *name, char phase, int lane, long long ts,
+                       long long arg);
+};
+
+/**
+ * CLASS NAME: TraceScope
+ *
+ * DESCRIPTION: Records its own lifetime as a slice of the timeline
+ */
+class TraceScope {
+   private:
+    const char *name;
+    int lane;
+    long long start;
+
    public:
-    FILE *logF;
-    int traceFileCreate();
-    int printToTrace(char *keyMessage,   // Message to be written as key
-                     char *valueMessage  // Message to be written as value
-    );
-    int traceFileClose();
-    int funcEntry(char *valueMessage  // Value
-    );
-    int funcExit(char *valueMessage,  // Value
-                 int f_rc = SUCCESS   // Function RC
-    );
+    TraceScope(const char *name, int lane)
+        : name(name), lane(lane), start(Trace::on() ? Trace::now() : -1) {}
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+    ~TraceScope() {
+        if (start >= 0) {
+            Trace::record(name, 'X', lane, start, Trace::now() - start);
+        }
+    }
 };
 
 #endif
@@ -41,6 +41,5 @@ using namespace std;
 
 #define STDCLLBKARGS (void *env, char *data, int size)
 #define STDCLLBKRET void
-#define DEBUGLOG 1
 
 #endif /* _STDINCLUDES_H_ */